@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <string.h>
+#include "backend.h"
+#include "solver.h"
+#include "parallel.h"
+#include "portfolio.h"
+
+/*
+ * This module keeps the registry of solver backends: the engines that solve boards, count their solutions
+ * and compute LP scores. One backend is active at a time and can be switched while the program runs.
+ * An operation the active backend doesn't have is run by the first registered backend that has it.
+ */
+
+/*
+ * All the backends. The first one is active when the program starts.
+ */
+static solver_backend backends[] =
+{
+	{"native", native_solve_board, parallel_count_solutions, NULL},
+	{"backtracking", native_solve_board, exhaustive_backtracking, NULL},
+	{"dlx", NULL, dlx_count_solutions, NULL},
+	{"sat", sat_solve_board, NULL, NULL},
+	{"gurobi", gurobi_solve_board, NULL, get_LP_scores},
+	{"portfolio", portfolio_solve_board, NULL, NULL}
+};
+
+#define NUM_BACKENDS ((int)(sizeof(backends)/sizeof(backends[0])))
+
+/*
+ * The index of the active backend in backends.
+ */
+static int active_backend = 0;
+
+BOOL set_solver_backend(char *name)
+{
+	/*
+	 * Makes the backend called name the active one.
+	 * Returns TRUE on success, FALSE if there is no such backend (the active backend doesn't change).
+	 */
+	int k;
+	for(k = 0; k < NUM_BACKENDS; k++)
+	{
+		if(strcmp(backends[k].name,name)==0)
+		{
+			active_backend = k;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+solver_backend* get_solver_backend()
+{
+	/*
+	 * Returns the active backend.
+	 */
+	return backends + active_backend;
+}
+
+void print_solver_backends()
+{
+	/*
+	 * Prints the names of all the backends and which one is active.
+	 */
+	int k;
+	printf("The solvers are:");
+	for(k = 0; k < NUM_BACKENDS; k++)
+	{
+		printf(" %s%s%s",backends[k].name,(k == active_backend) ? " (active)" : "",(k < NUM_BACKENDS-1) ? "," : ".\n");
+	}
+}
+
+BOOL backend_solve(sudoku_board *board, cancel_token *token)
+{
+	/*
+	 * Solves the board with the active backend, see solve_board.
+	 * Returns CANCELLED if token (may be NULL) was cancelled before the backend finished.
+	 */
+	int k;
+	if(backends[active_backend].solve != NULL)
+	{
+		return backends[active_backend].solve(board,token);
+	}
+	k = 0;
+	while(backends[k].solve == NULL)
+	{/*some backend has every operation*/
+		k++;
+	}
+	return backends[k].solve(board,token);
+}
+
+int backend_count(sudoku_board *board, int limit, cancel_token *token)
+{
+	/*
+	 * Counts the solutions of the board with the active backend, see count_solutions_bounded.
+	 * Returns CANCELLED if token (may be NULL) was cancelled before the backend finished.
+	 */
+	int k;
+	if(backends[active_backend].count != NULL)
+	{
+		return backends[active_backend].count(board,limit,token);
+	}
+	k = 0;
+	while(backends[k].count == NULL)
+	{/*some backend has every operation*/
+		k++;
+	}
+	return backends[k].count(board,limit,token);
+}
+
+double* backend_scores(sudoku_board *board, int *status, cancel_token *token)
+{
+	/*
+	 * Computes the LP scores of the board with the active backend, see get_LP_scores.
+	 * Returns NULL, with *status CANCELLED, if token (may be NULL) was cancelled before the backend finished.
+	 */
+	int k;
+	if(backends[active_backend].scores != NULL)
+	{
+		return backends[active_backend].scores(board,status,token);
+	}
+	k = 0;
+	while(backends[k].scores == NULL)
+	{/*some backend has every operation*/
+		k++;
+	}
+	return backends[k].scores(board,status,token);
+}
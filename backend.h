@@ -0,0 +1,58 @@
+#ifndef BACKEND_H_
+#define BACKEND_H_
+
+#include "definitions.h"
+#include "cancel.h"
+
+/*
+ * This module keeps the registry of solver backends: the engines that solve boards, count their solutions
+ * and compute LP scores. One backend is active at a time and can be switched while the program runs.
+ * An operation the active backend doesn't have is run by the first registered backend that has it.
+ */
+
+/*
+ * A solver backend. An operation the backend doesn't have is NULL.
+ */
+typedef struct solver_backend_struct
+{
+	char *name; /*the name of the backend in the solver command*/
+	BOOL (*solve)(sudoku_board *board, cancel_token *token); /*like solve_board, or CANCELLED if token (may be NULL) was cancelled first*/
+	int (*count)(sudoku_board *board, int limit, cancel_token *token); /*like count_solutions_bounded*/
+	double* (*scores)(sudoku_board *board, int *status, cancel_token *token); /*like get_LP_scores*/
+}solver_backend;
+
+/*
+ * Makes the backend called name the active one.
+ * Returns TRUE on success, FALSE if there is no such backend (the active backend doesn't change).
+ */
+BOOL set_solver_backend(char *name);
+
+/*
+ * Returns the active backend.
+ */
+solver_backend* get_solver_backend();
+
+/*
+ * Prints the names of all the backends and which one is active.
+ */
+void print_solver_backends();
+
+/*
+ * Solves the board with the active backend, see solve_board.
+ * Returns CANCELLED if token (may be NULL) was cancelled before the backend finished.
+ */
+BOOL backend_solve(sudoku_board *board, cancel_token *token);
+
+/*
+ * Counts the solutions of the board with the active backend, see count_solutions_bounded.
+ * Returns CANCELLED if token (may be NULL) was cancelled before the backend finished.
+ */
+int backend_count(sudoku_board *board, int limit, cancel_token *token);
+
+/*
+ * Computes the LP scores of the board with the active backend, see get_LP_scores.
+ * Returns NULL, with *status CANCELLED, if token (may be NULL) was cancelled before the backend finished.
+ */
+double* backend_scores(sudoku_board *board, int *status, cancel_token *token);
+
+#endif /* BACKEND_H_ */
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "main_aux.h"
+#include "solver.h"
+#include "matrix.h"
+#include "candidates.h"
+#include "groups.h"
+#include "cages.h"
+#include "cancel.h"
+#include "SPBufferset.h"
+#include "definitions.h"
+
+/*
+ * The throughput benchmark of the native solver, built with "make bench".
+ * For every square block size from 3x3 up to the largest board the solvers support, it fills an empty board
+ * and then solves BENCH_PUZZLES puzzles made by clearing BENCH_EMPTY_PERCENT percent of the cells of the
+ * filled board, and prints the seconds these took and the cells solved per second.
+ * An optional argument seeds rand(), so two runs can be compared on the same puzzles.
+ */
+
+/*
+ * The number of puzzles solved for every size.
+ */
+#define BENCH_PUZZLES (5)
+
+/*
+ * The percentage of the cells of a filled board that are cleared to make a puzzle.
+ */
+#define BENCH_EMPTY_PERCENT (85)
+
+/*
+ * The seconds a single fill or solve may take before the benchmark gives up on the size.
+ */
+#define BENCH_SECONDS (120.0)
+
+static sudoku_board* new_bench_board(int block_side)
+{
+	/*
+	 * Allocates an empty board with square blocks of side block_side.
+	 * Terminates the program on a memory allocation error.
+	 */
+	sudoku_board *board = (sudoku_board*)malloc(sizeof(sudoku_board));
+	int length = block_side*block_side;
+	check_alloc(board,"new_bench_board");
+	board->length = length;
+	board->block_horizontal = block_side;
+	board->block_vertical = block_side;
+	board->cells = make_matrix(length);
+	board->solution = make_matrix(length);
+	board->fixed_or_error = make_matrix(length);
+	board->region = make_matrix(length);
+	set_block_regions(board);
+	board->variant = 0;
+	board->groups = NULL;
+	update_groups(board);
+	board->cages = NULL;
+	board->marks = NULL;
+	board->monitor = NULL;
+	board->cache = NULL;
+	board->filled_cells = 0;
+	board->num_errors = 0;
+	board->isInit = TRUE;
+	return board;
+}
+
+static void free_bench_board(sudoku_board *board)
+{
+	/*
+	 * Frees all memory of board.
+	 */
+	free_matrix(board->cells,board->length);
+	free_matrix(board->solution,board->length);
+	free_matrix(board->fixed_or_error,board->length);
+	free_matrix(board->region,board->length);
+	free_group_table(board->groups);
+	free_cage_table(board->cages);
+	free(board);
+}
+
+static double timed_solve(sudoku_board *board)
+{
+	/*
+	 * Solves board with native_solve_board and returns the seconds it took,
+	 * or -1 if it wasn't solved within BENCH_SECONDS (or is unsolvable).
+	 */
+	cancel_token *token = new_cancel_token(NULL);
+	BOOL solved;
+	double left;
+	set_deadline(token,BENCH_SECONDS);
+	solved = native_solve_board(board,token);
+	left = get_time_left(token);
+	free_cancel_token(token);
+	return (solved == TRUE) ? BENCH_SECONDS - left : -1;
+}
+
+static void make_puzzle(sudoku_board *board, int **full)
+{
+	/*
+	 * Copies the filled board full to board->cells and clears BENCH_EMPTY_PERCENT percent of its cells at random.
+	 */
+	int length = board->length, num_cells = length*length;
+	int to_clear = num_cells*BENCH_EMPTY_PERCENT/100;
+	int cell;
+	copy_matrix(full,board->cells,length);
+	while(to_clear > 0)
+	{
+		cell = get_index(num_cells) - 1;
+		if(board->cells[cell%length][cell/length] != 0)
+		{
+			board->cells[cell%length][cell/length] = 0;
+			to_clear--;
+		}
+	}
+}
+
+static BOOL bench_size(int block_side)
+{
+	/*
+	 * Prints the line of the benchmark for square blocks of side block_side.
+	 * Returns FALSE if a fill or a solve ran out of time, TRUE otherwise.
+	 */
+	sudoku_board *board = new_bench_board(block_side);
+	int length = board->length, k, solved_cells;
+	int **full = make_matrix(length);
+	double seconds, fill_seconds, solve_seconds = 0;
+	BOOL result = TRUE;
+
+	printf("%2dx%-2d  ",length,length);
+	fill_seconds = timed_solve(board);
+	if(fill_seconds < 0)
+	{
+		printf("fill timed out\n");
+		result = FALSE;
+	}
+	else
+	{
+		copy_matrix(board->solution,full,length);
+		for(k = 0; k < BENCH_PUZZLES && result; k++)
+		{
+			make_puzzle(board,full);
+			seconds = timed_solve(board);
+			if(seconds < 0)
+			{
+				result = FALSE;
+			}
+			solve_seconds += seconds;
+		}
+		if(result)
+		{
+			solved_cells = BENCH_PUZZLES*(length*length*BENCH_EMPTY_PERCENT/100);
+			printf("%10.4f  %10.4f  %12.0f\n",fill_seconds,solve_seconds/BENCH_PUZZLES,
+					solve_seconds > 0 ? solved_cells/solve_seconds : 0);
+		}
+		else
+		{
+			printf("%10.4f  solve timed out\n",fill_seconds);
+		}
+	}
+	free_matrix(full,length);
+	free_bench_board(board);
+	return result;
+}
+
+/*
+ * The main function of the benchmark.
+ */
+int main(int argc, char *argv[])
+{
+	int block_side;
+	SP_BUFF_SET(); /*makes prints appear correctly*/
+	srand(argc > 1 ? atoi(argv[1]) : (int)time(NULL));
+	printf("size     fill (s)   solve (s)       cells/s\n");
+	for(block_side = 3; block_side*block_side <= MAX_LENGTH; block_side++)
+	{
+		if(!bench_size(block_side))
+		{/*the bigger sizes would run out of time as well*/
+			break;
+		}
+	}
+	return 0;
+}
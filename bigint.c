@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <string.h>
+#include "bigint.h"
+#include "main_aux.h"
+
+/*
+ * This module holds non-negative integers of any size, for solution counts that don't fit in an int.
+ * A number is kept as an array of 16 bit digits, least significant first, so every operation
+ * fits in an unsigned long on any platform.
+ */
+
+#define LIMB_BITS (16)
+#define LIMB_MASK (0xFFFFUL)
+
+struct bigint_struct
+{
+	unsigned int *limbs; /*limbs[k] is the k-th 16 bit digit, least significant first. The unused ones are 0*/
+	int num_limbs; /*the digits in use. Zero has none*/
+	int capacity; /*the size of limbs*/
+};
+
+static void ensure_capacity(bigint *n, int num_limbs)
+{
+	/*
+	 * Makes room for num_limbs digits in n. The new digits are 0.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int k;
+	if(num_limbs <= n->capacity)
+	{
+		return;
+	}
+	n->limbs = (unsigned int*)realloc(n->limbs,2*num_limbs*sizeof(unsigned int));
+	check_alloc(n->limbs,"bigint");
+	for(k = n->capacity; k < 2*num_limbs; k++)
+	{
+		n->limbs[k] = 0;
+	}
+	n->capacity = 2*num_limbs;
+}
+
+bigint* new_bigint(unsigned long value)
+{
+	/*
+	 * Allocates a bigint holding value.
+	 * Uses malloc, free it with free_bigint.
+	 * Terminates the program on a memory allocation error.
+	 */
+	bigint *n = (bigint*)malloc(sizeof(bigint));
+	check_alloc(n,"new_bigint");
+	n->limbs = NULL;
+	n->num_limbs = 0;
+	n->capacity = 0;
+	bigint_add_small(n,value);
+	return n;
+}
+
+void free_bigint(bigint *n)
+{
+	/*
+	 * Frees all memory of n. n may be NULL.
+	 */
+	if(n!=NULL)
+	{
+		free(n->limbs);
+		free(n);
+	}
+}
+
+void bigint_add_small(bigint *n, unsigned long value)
+{
+	/*
+	 * Adds value to n.
+	 * Terminates the program on a memory allocation error.
+	 */
+	unsigned long carry = value;
+	int k = 0;
+	while(carry != 0)
+	{
+		ensure_capacity(n,k+1);
+		carry += n->limbs[k];
+		n->limbs[k] = (unsigned int)(carry & LIMB_MASK);
+		carry >>= LIMB_BITS;
+		k++;
+		if(k > n->num_limbs)
+		{
+			n->num_limbs = k;
+		}
+	}
+}
+
+void bigint_add(bigint *n, bigint *m)
+{
+	/*
+	 * Adds m to n.
+	 * Terminates the program on a memory allocation error.
+	 */
+	unsigned long carry = 0;
+	int k, size = (n->num_limbs > m->num_limbs) ? n->num_limbs : m->num_limbs;
+	ensure_capacity(n,size+1);
+	for(k = 0; k < size; k++)
+	{
+		carry += n->limbs[k];
+		if(k < m->num_limbs)
+		{
+			carry += m->limbs[k];
+		}
+		n->limbs[k] = (unsigned int)(carry & LIMB_MASK);
+		carry >>= LIMB_BITS;
+	}
+	n->limbs[size] = (unsigned int)carry;
+	n->num_limbs = (carry != 0) ? size+1 : size;
+}
+
+void bigint_multiply_small(bigint *n, unsigned long factor)
+{
+	/*
+	 * Multiplies n by factor, which must be less than 65536.
+	 * Terminates the program on a memory allocation error.
+	 */
+	unsigned long carry = 0;
+	int k;
+	if(factor == 0)
+	{
+		n->num_limbs = 0;
+		for(k = 0; k < n->capacity; k++)
+		{
+			n->limbs[k] = 0;
+		}
+		return;
+	}
+	for(k = 0; k < n->num_limbs; k++)
+	{
+		carry += n->limbs[k]*factor;
+		n->limbs[k] = (unsigned int)(carry & LIMB_MASK);
+		carry >>= LIMB_BITS;
+	}
+	if(carry != 0)
+	{
+		ensure_capacity(n,n->num_limbs+1);
+		n->limbs[n->num_limbs] = (unsigned int)carry;
+		n->num_limbs++;
+	}
+}
+
+void bigint_multiply(bigint *n, bigint *m)
+{
+	/*
+	 * Multiplies n by m, digit by digit.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int size = n->num_limbs + m->num_limbs;
+	int capacity = size + 1;
+	unsigned int *product = (unsigned int*)calloc(capacity,sizeof(unsigned int));
+	unsigned long carry;
+	int i, j;
+	check_alloc(product,"bigint_multiply");
+
+	for(i = 0; i < n->num_limbs; i++)
+	{
+		carry = 0;
+		for(j = 0; j < m->num_limbs; j++)
+		{/*at most (2^16-1)^2 + 2*(2^16-1), which fits in 32 bits*/
+			carry += product[i+j] + (unsigned long)n->limbs[i]*m->limbs[j];
+			product[i+j] = (unsigned int)(carry & LIMB_MASK);
+			carry >>= LIMB_BITS;
+		}
+		product[i+m->num_limbs] = (unsigned int)carry;
+	}
+	while(size > 0 && product[size-1] == 0)
+	{
+		size--;
+	}
+	free(n->limbs);
+	n->limbs = product;
+	n->num_limbs = size;
+	n->capacity = capacity;
+}
+
+BOOL bigint_is_zero(bigint *n)
+{
+	/*
+	 * Returns TRUE if n is 0, FALSE otherwise.
+	 */
+	return n->num_limbs == 0;
+}
+
+char* bigint_to_string(bigint *n)
+{
+	/*
+	 * Returns n in decimal, as a string.
+	 * The number is divided by 10000 repeatedly, and the remainders are its decimal digits in groups of 4.
+	 * Uses malloc, the caller frees it.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int num_limbs = n->num_limbs;
+	int max_digits = 5*num_limbs + 1; /*a 16 bit digit is less than 5 decimal digits*/
+	unsigned int *quotient = (unsigned int*)malloc((num_limbs+1)*sizeof(unsigned int));
+	char *str = (char*)malloc(max_digits+1);
+	char *end = str + max_digits;
+	unsigned long rest;
+	int k, group;
+	check_alloc(quotient,"bigint_to_string");
+	check_alloc(str,"bigint_to_string");
+
+	if(num_limbs > 0)
+	{
+		memcpy(quotient,n->limbs,num_limbs*sizeof(unsigned int));
+	}
+	*end = '\0';
+	while(num_limbs > 0)
+	{
+		rest = 0;
+		for(k = num_limbs-1; k >= 0; k--)
+		{
+			rest = (rest << LIMB_BITS) | quotient[k];
+			quotient[k] = (unsigned int)(rest / 10000);
+			rest %= 10000;
+		}
+		while(num_limbs > 0 && quotient[num_limbs-1] == 0)
+		{
+			num_limbs--;
+		}
+		for(group = 0; group < 4 && (num_limbs > 0 || rest != 0); group++)
+		{/*the leading group has no leading zeros*/
+			*(--end) = (char)('0' + rest % 10);
+			rest /= 10;
+		}
+	}
+	if(*end == '\0')
+	{/*n is 0*/
+		*(--end) = '0';
+	}
+	memmove(str,end,strlen(end)+1);
+	free(quotient);
+	return str;
+}
@@ -0,0 +1,63 @@
+#ifndef BIGINT_H_
+#define BIGINT_H_
+
+#include <stdlib.h>
+#include "definitions.h"
+
+/*
+ * This module holds non-negative integers of any size, for solution counts that don't fit in an int.
+ * A number is kept as an array of 16 bit digits, least significant first, so every operation
+ * fits in an unsigned long on any platform.
+ */
+
+typedef struct bigint_struct bigint;
+
+/*
+ * Allocates a bigint holding value.
+ * Uses malloc, free it with free_bigint.
+ * Terminates the program on a memory allocation error.
+ */
+bigint* new_bigint(unsigned long value);
+
+/*
+ * Frees all memory of n. n may be NULL.
+ */
+void free_bigint(bigint *n);
+
+/*
+ * Adds value to n.
+ * Terminates the program on a memory allocation error.
+ */
+void bigint_add_small(bigint *n, unsigned long value);
+
+/*
+ * Adds m to n.
+ * Terminates the program on a memory allocation error.
+ */
+void bigint_add(bigint *n, bigint *m);
+
+/*
+ * Multiplies n by factor, which must be less than 65536.
+ * Terminates the program on a memory allocation error.
+ */
+void bigint_multiply_small(bigint *n, unsigned long factor);
+
+/*
+ * Multiplies n by m.
+ * Terminates the program on a memory allocation error.
+ */
+void bigint_multiply(bigint *n, bigint *m);
+
+/*
+ * Returns TRUE if n is 0, FALSE otherwise.
+ */
+BOOL bigint_is_zero(bigint *n);
+
+/*
+ * Returns n in decimal, as a string.
+ * Uses malloc, the caller frees it.
+ * Terminates the program on a memory allocation error.
+ */
+char* bigint_to_string(bigint *n);
+
+#endif /* BIGINT_H_ */
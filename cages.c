@@ -0,0 +1,219 @@
+#include "cages.h"
+
+/*
+ * This module keeps the cages of a killer sudoku: sets of cells whose digits are all different and add up
+ * to a given sum. Checking partial sums during a search is slow, so the digit sets that fill a cage
+ * (the combinations of its size and sum) are listed once, when the cage is added, and the digits that still
+ * fit a partly filled cage are the union of the combinations that contain its digits.
+ */
+
+cage_table* new_cage_table(int length)
+{
+	/*
+	 * Allocates a table with no cages for a board of length*length cells.
+	 * Uses malloc, free it with free_cage_table.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int num_cells = length*length;
+	int cell;
+	cage_table *cages = (cage_table*)malloc(sizeof(cage_table));
+	check_alloc(cages,"new_cage_table");
+
+	cages->length = length;
+	cages->num_cages = 0;
+	/*every cage has a cell of its own, so there are at most num_cells cages and num_cells caged cells*/
+	cages->first_cell = (int*)malloc((num_cells+1)*sizeof(int));
+	cages->cells = (int*)malloc(num_cells*sizeof(int));
+	cages->sum = (int*)malloc(num_cells*sizeof(int));
+	cages->cage_of = (int*)malloc(num_cells*sizeof(int));
+	cages->first_combination = (int*)malloc(num_cells*sizeof(int));
+	cages->last_combination = (int*)malloc(num_cells*sizeof(int));
+	check_alloc(cages->first_cell,"new_cage_table");
+	check_alloc(cages->cells,"new_cage_table");
+	check_alloc(cages->sum,"new_cage_table");
+	check_alloc(cages->cage_of,"new_cage_table");
+	check_alloc(cages->first_combination,"new_cage_table");
+	check_alloc(cages->last_combination,"new_cage_table");
+	cages->capacity = length;
+	cages->num_combinations = 0;
+	cages->combinations = (MASK*)malloc(cages->capacity*sizeof(MASK));
+	check_alloc(cages->combinations,"new_cage_table");
+
+	cages->first_cell[0] = 0;
+	for(cell = 0; cell < num_cells; cell++)
+	{
+		cages->cage_of[cell] = -1;
+	}
+	return cages;
+}
+
+void free_cage_table(cage_table *cages)
+{
+	/*
+	 * Frees all memory of cages. cages may be NULL.
+	 */
+	if(cages != NULL)
+	{
+		free(cages->first_cell);
+		free(cages->cells);
+		free(cages->sum);
+		free(cages->cage_of);
+		free(cages->first_combination);
+		free(cages->last_combination);
+		free(cages->combinations);
+		free(cages);
+	}
+}
+
+static BOOL add_combinations(cage_table *cages, int digit, int count, int sum, MASK chosen)
+{
+	/*
+	 * Appends to cages->combinations every set of count more digits, all of them digit or larger, that add up
+	 * to sum, each together with the digits already chosen.
+	 * Skips the digits that can't be completed: the count smallest digits from digit on must not add up to
+	 * more than sum, and the count largest digits must add up to at least sum.
+	 * Returns FALSE if the table would grow beyond MAX_CAGE_COMBINATIONS, TRUE otherwise.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int length = cages->length;
+	if(count == 0)
+	{
+		if(sum != 0)
+		{
+			return TRUE;
+		}
+		if(cages->num_combinations == MAX_CAGE_COMBINATIONS)
+		{
+			return FALSE;
+		}
+		if(cages->num_combinations == cages->capacity)
+		{
+			cages->capacity *= 2;
+			cages->combinations = (MASK*)realloc(cages->combinations,cages->capacity*sizeof(MASK));
+			check_alloc(cages->combinations,"add_cage");
+		}
+		cages->combinations[cages->num_combinations++] = chosen;
+		return TRUE;
+	}
+	if(count*length - count*(count-1)/2 < sum)
+	{/*even the largest digits are too small*/
+		return TRUE;
+	}
+	for(; digit <= length && count*digit + count*(count-1)/2 <= sum; digit++)
+	{/*the sums of count different digits from digit on are all the numbers between these bounds*/
+		if(!add_combinations(cages,digit+1,count-1,sum-digit,chosen | DIGIT_BIT(digit)))
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static void release_cells(cage_table *cages, int *cells, int count)
+{
+	/*
+	 * Takes the cells cells[0..count-1] out of their cage, for a cage that is not added after all.
+	 */
+	int k;
+	for(k = 0; k < count; k++)
+	{
+		cages->cage_of[cells[k]] = -1;
+	}
+}
+
+BOOL add_cage(cage_table *cages, int sum, int *cells, int size)
+{
+	/*
+	 * Adds a cage of the size cells cells[0..size-1] whose digits add up to sum.
+	 * Returns FALSE (and adds nothing) if a cell is already in a cage, if the cage has more than length cells,
+	 * if no digits fill it, or if its combinations would exceed MAX_CAGE_COMBINATIONS. TRUE otherwise.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int cage = cages->num_cages, first = cages->first_cell[cage];
+	int k, other;
+	int first_combination = cages->num_combinations;
+
+	if(size < 1 || size > cages->length)
+	{
+		return FALSE;
+	}
+	for(k = 0; k < size; k++)
+	{
+		if(cells[k] < 0 || cells[k] >= cages->length*cages->length || cages->cage_of[cells[k]] != -1)
+		{
+			release_cells(cages,cells,k);
+			return FALSE;
+		}
+		cages->cage_of[cells[k]] = cage; /*so a cell that appears twice is found*/
+	}
+
+	for(other = 0; other < cage; other++)
+	{/*a cage of the same size and sum lists the same combinations*/
+		if(cages->sum[other] == sum && cages->first_cell[other+1] - cages->first_cell[other] == size)
+		{
+			break;
+		}
+	}
+	if(other < cage)
+	{
+		cages->first_combination[cage] = cages->first_combination[other];
+		cages->last_combination[cage] = cages->last_combination[other];
+	}
+	else if(add_combinations(cages,1,size,sum,0) && cages->num_combinations > first_combination)
+	{
+		cages->first_combination[cage] = first_combination;
+		cages->last_combination[cage] = cages->num_combinations;
+	}
+	else
+	{/*no digits fill the cage, or too many do*/
+		cages->num_combinations = first_combination;
+		release_cells(cages,cells,size);
+		return FALSE;
+	}
+
+	for(k = 0; k < size; k++)
+	{
+		cages->cells[first + k] = cells[k];
+	}
+	cages->sum[cage] = sum;
+	cages->first_cell[cage+1] = first + size;
+	cages->num_cages++;
+	return TRUE;
+}
+
+MASK get_cage_digits(cage_table *cages, int cage, MASK placed)
+{
+	/*
+	 * Returns the digits that can still go in the empty cells of cage when the digits placed holds its filled cells:
+	 * the union of the combinations of the cage that contain placed, without placed.
+	 * Returns 0 if no combination contains placed.
+	 */
+	MASK digits = 0;
+	int k;
+	for(k = cages->first_combination[cage]; k < cages->last_combination[cage]; k++)
+	{
+		if((cages->combinations[k] & placed) == placed)
+		{
+			digits |= cages->combinations[k];
+		}
+	}
+	return digits & ~placed;
+}
+
+MASK get_cage_placed(cage_table *cages, int cage, int **M)
+{
+	/*
+	 * Returns the digits that the matrix M (M[i-1][j-1] is column i, row j) has in the cells of cage.
+	 */
+	MASK placed = 0;
+	int k, cell;
+	for(k = cages->first_cell[cage]; k < cages->first_cell[cage+1]; k++)
+	{
+		cell = cages->cells[k];
+		if(M[cell%cages->length][cell/cages->length] != 0)
+		{
+			placed |= DIGIT_BIT(M[cell%cages->length][cell/cages->length]);
+		}
+	}
+	return placed;
+}
@@ -0,0 +1,70 @@
+#ifndef CAGES_H_
+#define CAGES_H_
+
+#include <stdlib.h>
+#include "definitions.h"
+#include "main_aux.h"
+#include "candidates.h"
+
+/*
+ * This module keeps the cages of a killer sudoku: sets of cells whose digits are all different and add up
+ * to a given sum. Checking partial sums during a search is slow, so the digit sets that fill a cage
+ * (the combinations of its size and sum) are listed once, when the cage is added, and the digits that still
+ * fit a partly filled cage are the union of the combinations that contain its digits.
+ */
+
+/*
+ * The most combinations all the cages of a board may have together. A cage with more (a large cage on a large
+ * board) is rejected, so the tables stay small enough to scan on every placement.
+ */
+#define MAX_CAGE_COMBINATIONS (1 << 16)
+
+typedef struct cage_table_struct
+{
+	int length; /*the digits are 1...length*/
+	int num_cages;
+	int *first_cell; /*the cells of cage k are cells[first_cell[k]..first_cell[k+1]-1]*/
+	int *cells; /*cell = (i-1)+(j-1)*length for column i and row j*/
+	int *sum; /*sum[k] is the sum of the digits of cage k*/
+	int *cage_of; /*cage_of[cell] is the cage of cell, -1 if it is in none*/
+	int *first_combination; /*the digit sets that fill cage k are combinations[first_combination[k]..last_combination[k]-1].
+							 *Cages of the same size and sum share their combinations*/
+	int *last_combination;
+	MASK *combinations;
+	int num_combinations;
+	int capacity; /*the number of combinations there is room for*/
+}cage_table;
+
+/*
+ * Allocates a table with no cages for a board of length*length cells.
+ * Uses malloc, free it with free_cage_table.
+ * Terminates the program on a memory allocation error.
+ */
+cage_table* new_cage_table(int length);
+
+/*
+ * Frees all memory of cages. cages may be NULL.
+ */
+void free_cage_table(cage_table *cages);
+
+/*
+ * Adds a cage of the size cells cells[0..size-1] whose digits add up to sum.
+ * Returns FALSE (and adds nothing) if a cell is already in a cage, if the cage has more than length cells,
+ * if no digits fill it, or if its combinations would exceed MAX_CAGE_COMBINATIONS. TRUE otherwise.
+ * Terminates the program on a memory allocation error.
+ */
+BOOL add_cage(cage_table *cages, int sum, int *cells, int size);
+
+/*
+ * Returns the digits that can still go in the empty cells of cage when the digits placed holds its filled cells:
+ * the union of the combinations of the cage that contain placed, without placed.
+ * Returns 0 if no combination contains placed.
+ */
+MASK get_cage_digits(cage_table *cages, int cage, MASK placed);
+
+/*
+ * Returns the digits that the matrix M (M[i-1][j-1] is column i, row j) has in the cells of cage.
+ */
+MASK get_cage_placed(cage_table *cages, int cage, int **M);
+
+#endif /* CAGES_H_ */
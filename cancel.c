@@ -0,0 +1,115 @@
+#define _POSIX_C_SOURCE 200112L /*for pthreads and clock_gettime under -ansi*/
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cancel.h"
+#include "main_aux.h"
+
+/*
+ * This module lets one thread ask the solvers running on other threads to stop, and gives operations time budgets.
+ * A solver that is given a cancel token checks it every CANCEL_CHECK_INTERVAL steps of its search,
+ * and returns CANCELLED once the token was cancelled or its deadline passed.
+ */
+
+struct cancel_token_struct
+{
+	pthread_mutex_t lock; /*guards cancelled*/
+	BOOL cancelled;
+	double deadline; /*in the seconds of get_time, NO_DEADLINE if the token has none. Set before the token is shared*/
+	cancel_token *parent; /*NULL if the token has no parent*/
+};
+
+static double get_time()
+{
+	/*
+	 * Returns the seconds since some fixed point in the past, from a clock that is never set back.
+	 */
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC,&now);
+	return now.tv_sec + now.tv_nsec/1e9;
+}
+
+cancel_token* new_cancel_token(cancel_token *parent)
+{
+	/*
+	 * Allocates a token that isn't cancelled. If parent is not NULL, the token is also cancelled
+	 * whenever parent is, so an operation can be stopped by its own token or by its caller's.
+	 * Uses malloc, free it with free_cancel_token after every solver that uses it has returned.
+	 * Terminates the program on a memory allocation error.
+	 */
+	cancel_token *token = (cancel_token*)malloc(sizeof(cancel_token));
+	check_alloc(token,"new_cancel_token");
+	pthread_mutex_init(&token->lock,NULL);
+	token->cancelled = FALSE;
+	token->deadline = NO_DEADLINE;
+	token->parent = parent;
+	return token;
+}
+
+void free_cancel_token(cancel_token *token)
+{
+	/*
+	 * Frees all memory of token. token may be NULL.
+	 */
+	if(token != NULL)
+	{
+		pthread_mutex_destroy(&token->lock);
+		free(token);
+	}
+}
+
+void cancel_operation(cancel_token *token)
+{
+	/*
+	 * Cancels token. Can be called from any thread, any number of times.
+	 */
+	pthread_mutex_lock(&token->lock);
+	token->cancelled = TRUE;
+	pthread_mutex_unlock(&token->lock);
+}
+
+void set_deadline(cancel_token *token, double seconds)
+{
+	/*
+	 * Makes token cancel itself seconds (> 0) from now.
+	 */
+	token->deadline = get_time() + seconds;
+}
+
+BOOL is_cancelled(cancel_token *token)
+{
+	/*
+	 * Returns TRUE if token or one of its parents was cancelled or passed its deadline, FALSE otherwise.
+	 * A NULL token is never cancelled.
+	 */
+	BOOL cancelled = FALSE;
+	for(; token != NULL && !cancelled; token = token->parent)
+	{
+		pthread_mutex_lock(&token->lock);
+		cancelled = token->cancelled;
+		pthread_mutex_unlock(&token->lock);
+		if(!cancelled && token->deadline != NO_DEADLINE)
+		{
+			cancelled = (get_time() >= token->deadline);
+		}
+	}
+	return cancelled;
+}
+
+double get_time_left(cancel_token *token)
+{
+	/*
+	 * Returns the seconds left until the nearest deadline of token and its parents (0 if it passed),
+	 * or NO_DEADLINE if none of them has a deadline. token may be NULL.
+	 */
+	double left = NO_DEADLINE;
+	double now = get_time();
+	for(; token != NULL; token = token->parent)
+	{
+		if(token->deadline != NO_DEADLINE && (left == NO_DEADLINE || token->deadline - now < left))
+		{
+			left = (token->deadline > now) ? token->deadline - now : 0;
+		}
+	}
+	return left;
+}
@@ -0,0 +1,59 @@
+#ifndef CANCEL_H_
+#define CANCEL_H_
+
+#include "definitions.h"
+
+/*
+ * This module lets one thread ask the solvers running on other threads to stop, and gives operations time budgets.
+ * A solver that is given a cancel token checks it every CANCEL_CHECK_INTERVAL steps of its search,
+ * and returns CANCELLED once the token was cancelled or its deadline passed.
+ */
+
+/*
+ * How many search steps (nodes, decisions or conflicts) a solver makes between two checks of its token.
+ */
+#define CANCEL_CHECK_INTERVAL (1024)
+
+/*
+ * Returned by get_time_left for a token without a deadline.
+ */
+#define NO_DEADLINE (-1.0)
+
+typedef struct cancel_token_struct cancel_token;
+
+/*
+ * Allocates a token that isn't cancelled. If parent is not NULL, the token is also cancelled
+ * whenever parent is, so an operation can be stopped by its own token or by its caller's.
+ * Uses malloc, free it with free_cancel_token after every solver that uses it has returned.
+ * Terminates the program on a memory allocation error.
+ */
+cancel_token* new_cancel_token(cancel_token *parent);
+
+/*
+ * Frees all memory of token. token may be NULL.
+ */
+void free_cancel_token(cancel_token *token);
+
+/*
+ * Cancels token. Can be called from any thread, any number of times.
+ */
+void cancel_operation(cancel_token *token);
+
+/*
+ * Makes token cancel itself seconds (> 0) from now.
+ */
+void set_deadline(cancel_token *token, double seconds);
+
+/*
+ * Returns TRUE if token or one of its parents was cancelled or passed its deadline, FALSE otherwise.
+ * A NULL token is never cancelled.
+ */
+BOOL is_cancelled(cancel_token *token);
+
+/*
+ * Returns the seconds left until the nearest deadline of token and its parents (0 if it passed),
+ * or NO_DEADLINE if none of them has a deadline. token may be NULL.
+ */
+double get_time_left(cancel_token *token);
+
+#endif /* CANCEL_H_ */
@@ -0,0 +1,625 @@
+#include "candidates.h"
+#include "cages.h"
+
+/*
+ * This module keeps the digits used in every group of a sudoku grid (see groups.h) as bitmasks.
+ * It is the engine the solvers search on: finding the legal digits of a cell takes a few
+ * bitwise operations, and placing or clearing a digit never allocates memory.
+ */
+
+/*
+ * bits_in_byte[b] is the number of bits that are on in the byte b.
+ */
+#define B2(n) n, n+1, n+1, n+2
+#define B4(n) B2(n), B2(n+1), B2(n+1), B2(n+2)
+#define B6(n) B4(n), B4(n+1), B4(n+1), B4(n+2)
+static const unsigned char bits_in_byte[256] = { B6(0), B6(1), B6(1), B6(2) };
+
+/*
+ * The seed of the generator of the placement keys. The keys have their own generator,
+ * so making them doesn't change the random numbers the game draws with rand().
+ */
+#define KEY_SEED (2463534242UL)
+
+static unsigned long next_key_word(unsigned long *state)
+{
+	/*
+	 * Returns a random word and advances the 32 bit counter *state. Each 32 bits of the word are the counter
+	 * mixed by the finalizer of MurmurHash3, whose multiplications keep the keys from being linear combinations
+	 * of each other (a linear generator, like xorshift, would make different subtrees share keys).
+	 */
+	unsigned long word = 0, z;
+	size_t k;
+	for(k = 0; k < sizeof(unsigned long); k += 4)
+	{
+		*state = (*state + 0x9E3779B9UL) & 0xFFFFFFFFUL;
+		z = *state;
+		z = ((z ^ (z >> 16)) * 0x85EBCA6BUL) & 0xFFFFFFFFUL;
+		z = ((z ^ (z >> 13)) * 0xC2B2AE35UL) & 0xFFFFFFFFUL;
+		z ^= z >> 16;
+		word = (word << 16 << 16) | z;
+	}
+	return word;
+}
+
+static void make_keys(candidates *c)
+{
+	/*
+	 * Fills c->zobrist. Every cell, and every pair of a unit and a digit, gets a random key, and the key of
+	 * placing digit in cell is the xor of the keys of the cell and of its units with digit. A cage counts as a unit here.
+	 * So the xor of the keys of all the placements (c->key) depends only on which cells are filled and on which
+	 * digits every unit and every cage has, which is all the constraints the empty cells are left with.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int length = c->length;
+	int cell, digit, k, u;
+	int num_cages = (c->cages != NULL) ? c->cages->num_cages : 0; /*cage k gets the keys of unit num_units+k*/
+	unsigned long state = KEY_SEED;
+	unsigned long *cell_keys = (unsigned long*)malloc(c->num_cells*KEY_WORDS*sizeof(unsigned long));
+	unsigned long *unit_keys = (unsigned long*)malloc((c->num_units+num_cages)*length*KEY_WORDS*sizeof(unsigned long));
+	unsigned long *key;
+	check_alloc(cell_keys,"new_candidates");
+	check_alloc(unit_keys,"new_candidates");
+
+	for(k = 0; k < c->num_cells*KEY_WORDS; k++)
+	{
+		cell_keys[k] = next_key_word(&state);
+	}
+	for(k = 0; k < (c->num_units+num_cages)*length*KEY_WORDS; k++)
+	{
+		unit_keys[k] = next_key_word(&state);
+	}
+	for(cell = 0; cell < c->num_cells; cell++)
+	{
+		for(digit = 1; digit <= length; digit++)
+		{
+			key = c->zobrist + (cell*length + digit-1)*KEY_WORDS;
+			for(k = 0; k < KEY_WORDS; k++)
+			{
+				key[k] = cell_keys[cell*KEY_WORDS + k];
+				for(u = c->first_unit[cell]; u < c->first_unit[cell+1]; u++)
+				{
+					key[k] ^= unit_keys[(c->units_of[u]*length + digit-1)*KEY_WORDS + k];
+				}
+				if(num_cages > 0 && c->cages->cage_of[cell] != -1)
+				{
+					key[k] ^= unit_keys[((c->num_units + c->cages->cage_of[cell])*length + digit-1)*KEY_WORDS + k];
+				}
+			}
+		}
+	}
+	free(cell_keys);
+	free(unit_keys);
+}
+
+candidates* new_candidates(sudoku_board *board)
+{
+	/*
+	 * Allocates an empty candidates structure with the geometry of board, without a transposition table.
+	 * Uses malloc, free it with free_candidates.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int length = board->length;
+	group_table *groups = board->groups;
+	int num_cells = length*length;
+	int cell, k;
+	candidates *c = (candidates*)malloc(sizeof(candidates));
+	check_alloc(c,"new_candidates");
+
+	c->length = length;
+	c->num_cells = num_cells;
+	c->grid = (int*)calloc(num_cells,sizeof(int));
+	c->row_of = (int*)malloc(num_cells*sizeof(int));
+	c->column_of = (int*)malloc(num_cells*sizeof(int));
+	c->num_units = groups->num_groups;
+	c->region_of = (int*)malloc(num_cells*sizeof(int));
+	c->unit_used = (MASK*)calloc(c->num_units,sizeof(MASK));
+	check_alloc(c->grid,"new_candidates");
+	check_alloc(c->row_of,"new_candidates");
+	check_alloc(c->column_of,"new_candidates");
+	check_alloc(c->region_of,"new_candidates");
+	check_alloc(c->unit_used,"new_candidates");
+	c->row_used = c->unit_used;
+	c->column_used = c->unit_used + length;
+	c->region_used = c->unit_used + 2*length;
+	c->cages = board->cages;
+	c->cage_placed = NULL;
+	c->cage_allowed = NULL;
+	if(c->cages != NULL)
+	{
+		c->cage_placed = (MASK*)calloc(c->cages->num_cages+1,sizeof(MASK));
+		c->cage_allowed = (MASK*)calloc(c->cages->num_cages+1,sizeof(MASK));
+		check_alloc(c->cage_placed,"new_candidates");
+		check_alloc(c->cage_allowed,"new_candidates");
+		for(k = 0; k < c->cages->num_cages; k++)
+		{
+			c->cage_allowed[k] = get_cage_digits(c->cages,k,0);
+		}
+	}
+	c->extra_rules = (c->num_units > 3*length || c->cages != NULL);
+	c->unit_cells = (int*)malloc(c->num_units*length*sizeof(int));
+	c->first_unit = (int*)malloc((num_cells+1)*sizeof(int));
+	c->units_of = (int*)malloc(c->num_units*length*sizeof(int));
+	c->order = (int*)malloc(num_cells*sizeof(int));
+	c->order_index = (int*)malloc(num_cells*sizeof(int));
+	check_alloc(c->unit_cells,"new_candidates");
+	check_alloc(c->first_unit,"new_candidates");
+	check_alloc(c->units_of,"new_candidates");
+	check_alloc(c->order,"new_candidates");
+	check_alloc(c->order_index,"new_candidates");
+	c->unit_once = (MASK*)malloc(c->num_units*sizeof(MASK));
+	c->unit_twice = (MASK*)malloc(c->num_units*sizeof(MASK));
+	check_alloc(c->unit_once,"new_candidates");
+	check_alloc(c->unit_twice,"new_candidates");
+	c->zobrist = (unsigned long*)malloc(num_cells*length*KEY_WORDS*sizeof(unsigned long));
+	check_alloc(c->zobrist,"new_candidates");
+	c->frames = (search_frame*)malloc((num_cells+1)*sizeof(search_frame));
+	check_alloc(c->frames,"new_candidates");
+	c->num_empty = 0;
+	c->num_placed = 0;
+	for(k = 0; k < KEY_WORDS; k++)
+	{
+		c->key[k] = 0;
+	}
+	c->memo = NULL;
+
+	/*the geometry never changes, so it is computed once*/
+	for(cell = 0; cell < num_cells; cell++)
+	{
+		c->column_of[cell] = cell % length;
+		c->row_of[cell] = cell / length;
+		c->first_unit[cell] = groups->first_group[cell];
+		/*the third group of every cell is its region*/
+		c->region_of[cell] = groups->groups_of[groups->first_group[cell] + 2] - 2*length;
+	}
+	c->first_unit[num_cells] = groups->first_group[num_cells];
+	for(k = 0; k < c->num_units*length; k++)
+	{
+		c->unit_cells[k] = groups->cells[k];
+		c->units_of[k] = groups->groups_of[k];
+	}
+
+	make_keys(c);
+
+	c->all_digits = DIGIT_BIT(length) | (DIGIT_BIT(length) - 1);
+	return c;
+}
+
+int most_constrained_cell(candidates *c, int *cells, int num_cells)
+{
+	/*
+	 * Returns the index in cells (0 to num_cells-1) of the empty cell with the fewest candidates.
+	 * Stops early at a cell with no candidates or with a single candidate.
+	 * Assumes num_cells > 0.
+	 */
+	int k, count, best = 0;
+	int best_count = c->length + 1;
+	for(k = 0; k < num_cells; k++)
+	{
+		count = count_digits(get_cell_candidates(c,cells[k]));
+		if(count < best_count)
+		{
+			best = k;
+			best_count = count;
+			if(count <= 1)
+			{/*no cell can be better than this one*/
+				break;
+			}
+		}
+	}
+	return best;
+}
+
+void free_candidates(candidates *c)
+{
+	/*
+	 * Frees all memory of c. c may be NULL.
+	 */
+	if(c!=NULL)
+	{
+		free(c->grid);
+		free(c->row_of);
+		free(c->column_of);
+		free(c->region_of);
+		free(c->unit_used);
+		free(c->unit_cells);
+		free(c->first_unit);
+		free(c->units_of);
+		free(c->cage_placed);
+		free(c->cage_allowed);
+		free(c->order);
+		free(c->order_index);
+		free(c->unit_once);
+		free(c->unit_twice);
+		free(c->zobrist);
+		free(c->frames);
+		free_transposition_table(c->memo);
+		free(c);
+	}
+}
+
+BOOL load_candidates(candidates *c, int **M)
+{
+	/*
+	 * Clears c and places all the values of the matrix M (M[i-1][j-1] is column i, row j) in it.
+	 * Returns FALSE if M contains the same digit twice in a unit (c is left partially loaded),
+	 * TRUE otherwise.
+	 */
+	int cell, digit, k;
+
+	for(k = 0; k < c->num_units; k++)
+	{
+		c->unit_used[k] = 0;
+	}
+	for(cell = 0; cell < c->num_cells; cell++)
+	{
+		c->grid[cell] = 0;
+	}
+	for(k = 0; k < KEY_WORDS; k++)
+	{
+		c->key[k] = 0;
+	}
+	for(k = 0; c->cages != NULL && k < c->cages->num_cages; k++)
+	{
+		c->cage_placed[k] = 0;
+		c->cage_allowed[k] = get_cage_digits(c->cages,k,0);
+	}
+
+	for(cell = 0; cell < c->num_cells; cell++)
+	{
+		digit = M[c->column_of[cell]][c->row_of[cell]];
+		if(digit != 0)
+		{
+			if(!(get_cell_candidates(c,cell) & DIGIT_BIT(digit)))
+			{/*the digit already appears in a neighbor, or doesn't fit its cage*/
+				return FALSE;
+			}
+			place_digit(c,cell,digit);
+		}
+	}
+	return TRUE;
+}
+
+static MASK get_extra_used(candidates *c, int cell)
+{
+	/*
+	 * Returns the digits ruled out in cell by the extra rules: the digits placed in its extra units (the units after
+	 * its row, column and region), and the digits that don't fit the sum of its cage.
+	 * Kept out of get_cell_candidates, so a regular board only pays for a test.
+	 */
+	MASK used = 0;
+	int k;
+	for(k = c->first_unit[cell] + 3; k < c->first_unit[cell+1]; k++)
+	{
+		used |= c->unit_used[c->units_of[k]];
+	}
+	if(c->cages != NULL && c->cages->cage_of[cell] != -1)
+	{
+		used |= ~c->cage_allowed[c->cages->cage_of[cell]];
+	}
+	return used;
+}
+
+static void mark_extra_rules(candidates *c, int cell, MASK bit, BOOL used)
+{
+	/*
+	 * Marks bit as used (if used is TRUE) or as unused in the extra units of cell and in its cage.
+	 * The digits that fit the cage are looked up again in its combinations.
+	 */
+	int k, cage;
+	for(k = c->first_unit[cell] + 3; k < c->first_unit[cell+1]; k++)
+	{
+		if(used)
+		{
+			c->unit_used[c->units_of[k]] |= bit;
+		}
+		else
+		{
+			c->unit_used[c->units_of[k]] &= ~bit;
+		}
+	}
+	if(c->cages != NULL && (cage = c->cages->cage_of[cell]) != -1)
+	{
+		c->cage_placed[cage] = used ? (c->cage_placed[cage] | bit) : (c->cage_placed[cage] & ~bit);
+		c->cage_allowed[cage] = get_cage_digits(c->cages,cage,c->cage_placed[cage]);
+	}
+}
+
+MASK get_cell_candidates(candidates *c, int cell)
+{
+	/*
+	 * Returns the set of digits that can be placed in cell without repeating a digit of one of its units
+	 * and that still fit the sum of its cage.
+	 * Does not check whether cell is empty.
+	 */
+	MASK used = c->row_used[c->row_of[cell]] | c->column_used[c->column_of[cell]] | c->region_used[c->region_of[cell]];
+	if(c->extra_rules)
+	{
+		used |= get_extra_used(c,cell);
+	}
+	return c->all_digits & ~used;
+}
+
+void place_digit(candidates *c, int cell, int digit)
+{
+	/*
+	 * Places digit in the empty cell and marks it as used in the cell's units.
+	 */
+	MASK bit = DIGIT_BIT(digit);
+	int k;
+	unsigned long *key = c->zobrist + (cell*c->length + digit-1)*KEY_WORDS;
+	c->grid[cell] = digit;
+	c->row_used[c->row_of[cell]] |= bit;
+	c->column_used[c->column_of[cell]] |= bit;
+	c->region_used[c->region_of[cell]] |= bit;
+	if(c->extra_rules)
+	{
+		mark_extra_rules(c,cell,bit,TRUE);
+	}
+	for(k = 0; k < KEY_WORDS; k++)
+	{
+		c->key[k] ^= key[k];
+	}
+}
+
+void clear_digit(candidates *c, int cell)
+{
+	/*
+	 * Clears the filled cell and marks its digit as unused in the cell's units.
+	 */
+	MASK bit = DIGIT_BIT(c->grid[cell]);
+	int k;
+	unsigned long *key = c->zobrist + (cell*c->length + c->grid[cell]-1)*KEY_WORDS;
+	c->grid[cell] = 0;
+	c->row_used[c->row_of[cell]] &= ~bit;
+	c->column_used[c->column_of[cell]] &= ~bit;
+	c->region_used[c->region_of[cell]] &= ~bit;
+	if(c->extra_rules)
+	{
+		mark_extra_rules(c,cell,bit,FALSE);
+	}
+	for(k = 0; k < KEY_WORDS; k++)
+	{
+		c->key[k] ^= key[k];
+	}
+}
+
+void start_trail(candidates *c)
+{
+	/*
+	 * Starts a new trail: every cell that is currently empty is put in c->order and c->num_placed becomes 0.
+	 */
+	int cell;
+	c->num_empty = 0;
+	c->num_placed = 0;
+	for(cell = 0; cell < c->num_cells; cell++)
+	{
+		if(c->grid[cell] == 0)
+		{
+			c->order[c->num_empty] = cell;
+			c->order_index[cell] = c->num_empty;
+			c->num_empty++;
+		}
+	}
+}
+
+void shuffle_trail(candidates *c)
+{
+	/*
+	 * Shuffles the cells of the trail that are still empty (order[num_placed..num_empty-1]) with rand(),
+	 * so the search breaks the ties between equally constrained cells differently.
+	 */
+	int k, other, cell;
+	for(k = c->num_empty - 1; k > c->num_placed; k--)
+	{
+		other = c->num_placed + get_index(k - c->num_placed + 1) - 1;
+		cell = c->order[k];
+		c->order[k] = c->order[other];
+		c->order[other] = cell;
+		c->order_index[c->order[k]] = k;
+		c->order_index[cell] = other;
+	}
+}
+
+void assign_digit(candidates *c, int cell, int digit)
+{
+	/*
+	 * Places digit in the empty cell and records the placement in the trail.
+	 * Assumes cell is one of order[num_placed..num_empty-1].
+	 */
+	int k = c->order_index[cell];
+	/*swap the cell to the end of the trail*/
+	c->order[k] = c->order[c->num_placed];
+	c->order_index[c->order[k]] = k;
+	c->order[c->num_placed] = cell;
+	c->order_index[cell] = c->num_placed;
+	c->num_placed++;
+	place_digit(c,cell,digit);
+}
+
+void undo_trail(candidates *c, int mark)
+{
+	/*
+	 * Clears the cells placed on the trail after it had mark placements, latest first,
+	 * so that c->num_placed becomes mark again.
+	 */
+	while(c->num_placed > mark)
+	{
+		c->num_placed--;
+		clear_digit(c,c->order[c->num_placed]);
+	}
+}
+
+static MASK get_unit_used(candidates *c, int unit)
+{
+	/*
+	 * Returns the digits placed in unit (see unit_cells for the numbering of the units).
+	 */
+	return c->unit_used[unit];
+}
+
+static int fill_naked_singles(candidates *c)
+{
+	/*
+	 * Fills every empty cell that has a single candidate, until there are none.
+	 * Returns the number of cells filled, or ERROR if an empty cell has no candidates.
+	 */
+	int k, cell, filled = 0;
+	MASK legal;
+	BOOL changed = TRUE;
+	while(changed)
+	{
+		changed = FALSE;
+		for(k = c->num_placed; k < c->num_empty; k++)
+		{
+			cell = c->order[k];
+			legal = get_cell_candidates(c,cell);
+			if(legal == 0)
+			{
+				return ERROR;
+			}
+			if((legal & (legal - 1)) == 0)
+			{/*a single bit is on*/
+				/*the cell at k is replaced by a cell that was already checked in this pass*/
+				assign_digit(c,cell,lowest_digit(legal));
+				filled++;
+				changed = TRUE;
+			}
+		}
+	}
+	return filled;
+}
+
+static int fill_hidden_singles(candidates *c)
+{
+	/*
+	 * Fills every digit that fits a single empty cell of some unit.
+	 * The places of the digits in all the units are collected first, in one pass over the empty cells,
+	 * so a unit isn't rescanned for every empty cell in it. The cells filled after that only remove places,
+	 * so a digit of a later unit that is left with no place or a single place shows up in the next call.
+	 * Returns the number of cells filled, or ERROR if a unit misses a digit that fits none of its empty cells.
+	 */
+	int length = c->length;
+	int unit, k, u, cell, digit, filled = 0;
+	int *cells;
+	MASK legal, missing, hidden;
+	MASK *once = c->unit_once, *twice = c->unit_twice;
+
+	for(unit = 0; unit < c->num_units; unit++)
+	{
+		once[unit] = 0;
+		twice[unit] = 0;
+	}
+	for(k = c->num_placed; k < c->num_empty; k++)
+	{
+		cell = c->order[k];
+		legal = get_cell_candidates(c,cell);
+		unit = c->row_of[cell];
+		twice[unit] |= once[unit] & legal;
+		once[unit] |= legal;
+		unit = length + c->column_of[cell];
+		twice[unit] |= once[unit] & legal;
+		once[unit] |= legal;
+		unit = 2*length + c->region_of[cell];
+		twice[unit] |= once[unit] & legal;
+		once[unit] |= legal;
+		if(c->extra_rules)
+		{
+			for(u = c->first_unit[cell] + 3; u < c->first_unit[cell+1]; u++)
+			{
+				unit = c->units_of[u];
+				twice[unit] |= once[unit] & legal;
+				once[unit] |= legal;
+			}
+		}
+	}
+	for(unit = 0; unit < c->num_units; unit++)
+	{
+		missing = c->all_digits & ~get_unit_used(c,unit);
+		if(missing & ~once[unit])
+		{/*a digit has nowhere to go in this unit*/
+			return ERROR;
+		}
+		hidden = missing & once[unit] & ~twice[unit];
+		cells = c->unit_cells + unit*length;
+		while(hidden != 0)
+		{
+			digit = lowest_digit(hidden);
+			hidden &= ~DIGIT_BIT(digit);
+			for(k = 0; k < length; k++)
+			{
+				cell = cells[k];
+				if(c->grid[cell] == 0 && (get_cell_candidates(c,cell) & DIGIT_BIT(digit)))
+				{
+					assign_digit(c,cell,digit);
+					filled++;
+					break;
+				}
+			}
+			if(k == length)
+			{/*a cell filled since the places were collected took the only place of this digit*/
+				return ERROR;
+			}
+		}
+	}
+	return filled;
+}
+
+BOOL propagate(candidates *c)
+{
+	/*
+	 * Fills, on the trail, every cell that is forced by the current grid and repeats until nothing is forced:
+	 * naked singles (an empty cell with a single candidate) and hidden singles (a digit that fits only
+	 * one empty cell of a unit).
+	 * Returns FALSE if a contradiction was found (an empty cell without candidates, or a digit missing
+	 * from a unit that can't be placed anywhere in it), TRUE otherwise.
+	 * Either way, the placements can be undone with undo_trail.
+	 */
+	int filled;
+	do
+	{
+		if(fill_naked_singles(c) == ERROR)
+		{
+			return FALSE;
+		}
+		if(c->num_placed == c->num_empty)
+		{/*the grid is full*/
+			return TRUE;
+		}
+		filled = fill_hidden_singles(c);
+		if(filled == ERROR)
+		{
+			return FALSE;
+		}
+	}while(filled > 0);
+	return TRUE;
+}
+
+int count_digits(MASK m)
+{
+	/*
+	 * Returns the number of digits in the set m.
+	 */
+	int count = 0;
+	while(m != 0)
+	{
+		count += bits_in_byte[m & 0xFF];
+		m >>= 8;
+	}
+	return count;
+}
+
+int lowest_digit(MASK m)
+{
+	/*
+	 * Returns the smallest digit in the set m. Assumes m is not empty.
+	 */
+	int digit = 1;
+	while(!(m & 0xFF))
+	{/*skip the empty bytes of the wide masks of big boards*/
+		m >>= 8;
+		digit += 8;
+	}
+	/*the bits below the lowest one, counted with the byte table*/
+	return digit + bits_in_byte[((m & (~m + 1)) - 1) & 0xFF];
+}
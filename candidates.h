@@ -0,0 +1,179 @@
+#ifndef CANDIDATES_H_
+#define CANDIDATES_H_
+
+#include <stdlib.h>
+#include <limits.h>
+#include "definitions.h"
+#include "main_aux.h"
+#include "transposition.h"
+#include "groups.h"
+
+struct cage_table_struct; /*see cages.h, which needs MASK from here*/
+
+/*
+ * This module keeps the digits used in every group of a sudoku grid (see groups.h) as bitmasks.
+ * It is the engine the solvers search on: finding the legal digits of a cell takes a few
+ * bitwise operations, and placing or clearing a digit never allocates memory.
+ */
+
+/*
+ * A set of digits. Bit d-1 is on iff digit d is in the set.
+ * A MASK has 64 bits: ANSI C has no 64-bit integer type, so it is an unsigned long,
+ * and the build stops where unsigned long is narrower.
+ */
+typedef unsigned long MASK;
+#if (ULONG_MAX >> 31 >> 31) < 3
+#error "MASK needs an unsigned long of at least 64 bits"
+#endif
+
+/*
+ * The largest side of a board the solvers support: a MASK has a bit per digit, and values are printed
+ * with two digits, so boards are at most 64x64.
+ */
+#define MAX_LENGTH (64)
+
+/*
+ * The bit representing digit in a MASK (digit >= 1).
+ */
+#define DIGIT_BIT(digit) (((MASK)1) << ((digit) - 1))
+
+/*
+ * A node of the backtracking search of count_completions, kept on the frame stack of the candidates
+ * so the search allocates no memory of its own.
+ */
+typedef struct search_frame_struct
+{
+	int cell; /*the cell branched on*/
+	int mark; /*the length of the trail before the digit being tried was placed*/
+	MASK remaining; /*the digits of cell not yet tried*/
+	int solutions_before; /*the solutions found when the node was entered, for the transposition table*/
+	unsigned long nodes_before; /*the search nodes visited when the node was entered, for the transposition table*/
+	unsigned long key[KEY_WORDS]; /*the key of the node, for the transposition table*/
+}search_frame;
+
+typedef struct candidates_struct
+{
+	int length; /*the size of the grid is length*length*/
+	int num_cells; /*length*length*/
+	int *grid; /*grid[cell] is the digit placed in cell, 0 if empty. cell = (i-1)+(j-1)*length for column i and row j*/
+	int *row_of; /*row_of[cell] is the row index (from 0) of cell*/
+	int *column_of; /*column_of[cell] is the column index (from 0) of cell*/
+	int *region_of; /*region_of[cell] is the region index (from 0) of cell*/
+	int num_units; /*the number of groups of the board, called units here*/
+	MASK *unit_used; /*unit_used[u] holds the digits placed in unit u*/
+	MASK *row_used; /*the part of unit_used of the rows, row_used[r] is unit_used[r]*/
+	MASK *column_used; /*the part of unit_used of the columns*/
+	MASK *region_used; /*the part of unit_used of the regions*/
+	MASK all_digits; /*the set {1,...,length}*/
+	int *unit_cells; /*unit_cells[u*length+k] is the k-th cell of unit u. Units 0..length-1 are the rows,
+					  *units length..2*length-1 are the columns, units 2*length..3*length-1 are the regions
+					  *and the extra groups of a variant come after them, like in the group table of the board*/
+	int *first_unit; /*the units of cell are units_of[first_unit[cell]..first_unit[cell+1]-1], in increasing order,
+					  *so its row, column and region come first and its extra units after them. The hot paths
+					  *go to the first three directly, which on a regular board are all the units of the cell*/
+	int *units_of;
+	struct cage_table_struct *cages; /*the cages of the board, NULL if it has none. Shared with the board*/
+	MASK *cage_placed; /*cage_placed[k] holds the digits placed in cage k*/
+	MASK *cage_allowed; /*cage_allowed[k] holds the digits that can still go in the empty cells of cage k*/
+	BOOL extra_rules; /*TRUE if some cell has more units than its row, column and region, or the board has cages*/
+	int *order; /*the cells that were empty when the trail was started. order[0..num_placed-1] were
+				 *filled since then, in the order they were filled, which makes it the undo trail*/
+	int *order_index; /*order_index[cell] is the position of the cell in order, if it is there*/
+	int num_empty; /*number of cells in order*/
+	int num_placed; /*number of cells in order that were filled since the trail was started*/
+	MASK *unit_once; /*scratch of propagate: unit_once[u] holds the digits that fit at least one empty cell of unit u*/
+	MASK *unit_twice; /*scratch of propagate: unit_twice[u] holds the digits that fit at least two empty cells of unit u*/
+	unsigned long *zobrist; /*zobrist[(cell*length + digit-1)*KEY_WORDS + k] is word k of the key of placing digit in cell*/
+	unsigned long key[KEY_WORDS]; /*the xor of the keys of all the placements, see new_candidates*/
+	transposition_table *memo; /*the counts of subtrees the counter remembers, NULL if it doesn't memoize.
+								*Freed with c*/
+	search_frame *frames; /*the frame stack of the search, num_cells+1 frames: one per depth, and every branch fills a cell*/
+}candidates;
+
+/*
+ * Allocates an empty candidates structure with the geometry of board, without a transposition table.
+ * Uses malloc, free it with free_candidates.
+ * Terminates the program on a memory allocation error.
+ */
+candidates* new_candidates(sudoku_board *board);
+
+/*
+ * Frees all memory of c. c may be NULL.
+ */
+void free_candidates(candidates *c);
+
+/*
+ * Clears c and places all the values of the matrix M (M[i-1][j-1] is column i, row j) in it.
+ * Returns FALSE if M contains the same digit twice in a unit or digits that don't fit a cage (c is left partially loaded),
+ * TRUE otherwise.
+ */
+BOOL load_candidates(candidates *c, int **M);
+
+/*
+ * Returns the set of digits that can be placed in cell without repeating a digit of one of its units
+ * and that still fit the sum of its cage.
+ * Does not check whether cell is empty.
+ */
+MASK get_cell_candidates(candidates *c, int cell);
+
+/*
+ * Places digit in the empty cell and marks it as used in the cell's units.
+ */
+void place_digit(candidates *c, int cell, int digit);
+
+/*
+ * Clears the filled cell and marks its digit as unused in the cell's units.
+ */
+void clear_digit(candidates *c, int cell);
+
+/*
+ * Returns the index in cells (0 to num_cells-1) of the empty cell with the fewest candidates.
+ * Stops early at a cell with no candidates or with a single candidate.
+ * Assumes num_cells > 0.
+ */
+int most_constrained_cell(candidates *c, int *cells, int num_cells);
+
+/*
+ * Starts a new trail: every cell that is currently empty is put in c->order and c->num_placed becomes 0.
+ */
+void start_trail(candidates *c);
+
+/*
+ * Shuffles the cells of the trail that are still empty (order[num_placed..num_empty-1]) with rand(),
+ * so the search breaks the ties between equally constrained cells differently.
+ */
+void shuffle_trail(candidates *c);
+
+/*
+ * Places digit in the empty cell and records the placement in the trail.
+ * Assumes cell is one of order[num_placed..num_empty-1].
+ */
+void assign_digit(candidates *c, int cell, int digit);
+
+/*
+ * Clears the cells placed on the trail after it had mark placements, latest first,
+ * so that c->num_placed becomes mark again.
+ */
+void undo_trail(candidates *c, int mark);
+
+/*
+ * Fills, on the trail, every cell that is forced by the current grid and repeats until nothing is forced:
+ * naked singles (an empty cell with a single candidate) and hidden singles (a digit that fits only
+ * one empty cell of a unit).
+ * Returns FALSE if a contradiction was found (an empty cell without candidates, or a digit missing
+ * from a unit that can't be placed anywhere in it), TRUE otherwise.
+ * Either way, the placements can be undone with undo_trail.
+ */
+BOOL propagate(candidates *c);
+
+/*
+ * Returns the number of digits in the set m.
+ */
+int count_digits(MASK m);
+
+/*
+ * Returns the smallest digit in the set m. Assumes m is not empty.
+ */
+int lowest_digit(MASK m);
+
+#endif /* CANDIDATES_H_ */
@@ -11,6 +11,7 @@ typedef int BOOL;
 #define FALSE 	(0)
 
 #define ERROR   (-1)
+#define CANCELLED (-2) /*returned by a solver that was stopped by its cancel token*/
 
 typedef int 	STATUS;
 
@@ -24,6 +25,12 @@ typedef int 	STATUS;
 
 #define MEM_ALLOC_ERR (-1)
 
+#define NO_LIMIT (0) /*the limit of the solution counting functions that counts all the solutions*/
+
+/*the groups of a variant beyond the rows, the columns and the regions, combined with | in board->variant*/
+#define DIAGONAL_GROUPS (1) /*the two main diagonals (X-sudoku)*/
+#define WINDOKU_GROUPS (2) /*the windows between the blocks (windoku)*/
+
 typedef struct sudoku_board_struct
 {
 	int length; /*the size of the board is length*length */
@@ -36,6 +43,17 @@ typedef struct sudoku_board_struct
 	int num_errors; /*Tells how many errors the boards has. If the board has 2 neighbor cells which
 	*contain the same value the number of errors is 1. Every time a cell was set to have the same value as one
 	*of its neighbors this parameter is increased by 1.*/
+	int **region; /*region[i-1][j-1] is the region (from 0) of column i, row j: its block, or its piece of a jigsaw*/
+	int variant; /*the extra groups of the board, DIAGONAL_GROUPS and WINDOKU_GROUPS combined, 0 for none*/
+	struct group_table_struct *groups; /*the all-different groups of the board, see groups.h.
+										*Rebuilt with update_groups when region or variant change*/
+	struct cage_table_struct *cages; /*the cages of a killer sudoku, see cages.h. NULL if the board has none*/
+	struct pencil_marks_struct *marks; /*the legal values of every cell, see pencil.h. Kept up to date by write_cell,
+										*NULL on a board that isn't played (such as the boards of the benchmark)*/
+	struct candidates_struct *monitor; /*the candidates the solvability checks run on, see monitor.h.
+										*NULL until the first check, and freed when the groups or the cages change*/
+	struct solve_cache_struct *cache; /*what the solvers found out about the cells, see solve_cache.h.
+									   *NULL until the first result, and freed when the groups or the cages change*/
 	BOOL isInit; /*TRUE if all the 2D arrays in board were allocated*/
 }sudoku_board;
 
@@ -7,6 +7,13 @@
 #include "main_aux.h"
 #include "solver.h"
 #include "matrix.h"
+#include "solution_writer.h"
+#include "symmetry.h"
+#include "groups.h"
+#include "cages.h"
+#include "pencil.h"
+#include "monitor.h"
+#include "solve_cache.h"
 
 /*
  *This module encapsulates the Sudoku puzzle game and the Sudoku board.
@@ -16,6 +23,24 @@
 
 int mark_errors = 1; /*A global parameter with value of either 1(True) or 0(False) which determines whether errors in the Sudoku puzzle are displayed.*/
 
+static int monitor_solvability = 0; /*1 if the prompt of Solve mode tells whether the board can still be solved, 0 otherwise*/
+
+static double time_budget = 0; /*The seconds a command that runs a solver may take, 0 means no limit.*/
+
+static cancel_token* new_command_token()
+{
+	/*
+	 * Returns a cancel token for the solvers of one command, which runs out of time after time_budget seconds.
+	 * Free it with free_cancel_token.
+	 */
+	cancel_token *token = new_cancel_token(NULL);
+	if(time_budget > 0)
+	{
+		set_deadline(token,time_budget);
+	}
+	return token;
+}
+
 static void generate_fixed_cells_from_solution(sudoku_board *board, int **prev_cells)
 {
 	/*
@@ -99,9 +124,10 @@ void generate(sudoku_board *board, int num_to_fill, int num_fixed)
 {
 	/*
 	 * Generates a puzzle by randomly filling num_to_fill empty cells on the current board with legal values,
-	 * running ILP to solve the board, and then clearing all but (any) num_fixed random cells.
+	 * drawing a random solution of the filled board with sample_solution, and then clearing all but (any) num_fixed random cells.
 	 * Assumes num_to_fill and num_fixed are legal values and in the correct range, plus the board is not erroneous.
 	 * The method prints the board if the command was executed successfully.
+	 * If the board is unsolvable or the command runs out of its time budget, the board and the moves are left as they were.
 	 */
 	int length = board->length;
 	int num_previously_filled = board->filled_cells;
@@ -115,7 +141,10 @@ void generate(sudoku_board *board, int num_to_fill, int num_fixed)
 	int tries;
 	const int MAX_ITERATIONS = 1000;
 	BOOL successful = FALSE;
-	char command_info[8+1+2+1+2+1];/*command_info for the move structure. "generate"+space+(2 digits)+space+(2 digits)+\0*/
+	BOOL solvable = TRUE; /*whether the board before the fills has a solution, checked after the first failed try*/
+	BOOL checked_solvable = FALSE;
+	char command_info[8+1+4+1+4+1];/*command_info for the move structure. "generate"+space+(4 digits)+space+(4 digits)+\0*/
+	cancel_token *token = new_command_token();
 
 	empty_cells_array = find_empty_cells(board, num_empty_cells);
 	prev_cells = make_matrix(length);
@@ -126,6 +155,11 @@ void generate(sudoku_board *board, int num_to_fill, int num_fixed)
 
 	for(tries = 0; tries < MAX_ITERATIONS; tries++)
 	{
+		if(is_cancelled(token))
+		{/*board->cells was reverted at the end of the previous try*/
+			successful = CANCELLED;
+			break;
+		}
 		num_filled = 0;
 		/*filling empty cells*/
 		while ( num_filled < num_to_fill )
@@ -167,21 +201,25 @@ void generate(sudoku_board *board, int num_to_fill, int num_fixed)
 			continue;
 		}
 
-		successful = solve_board(board); /*solve_board takes care of reverting the solution to its original state*/
+		successful = sample_solution(board,token); /*only board->solution is changed*/
 		if(successful==TRUE)
 		{/*if "num_to_fill" empty cells were filled and there is a solution*/
 			break;
 		}
-		/*unsuccessful or error*/
+		/*unsuccessful or cancelled*/
 		copy_matrix(prev_cells,board->cells,length);
+		if(successful==FALSE && !checked_solvable)
+		{/*no fill can help if the board itself has no solution*/
+			checked_solvable = TRUE;
+			solvable = solve_board(board,token);
+			if(solvable!=TRUE)
+			{
+				successful = (solvable==CANCELLED) ? CANCELLED : FALSE;
+				break;
+			}
+		}
 	}
-	if(successful==FALSE)
-	{
-		print_too_many_iterations("generate_board");
-		/*remove the new move we added*/
-		revert_new_move(board, EDIT);
-		return;
-	}
+	free_cancel_token(token);
 
 	/*free empty_cells_array*/
 	for(k = 0; k < num_empty_cells; k++)
@@ -190,6 +228,27 @@ void generate(sudoku_board *board, int num_to_fill, int num_fixed)
 	}
 	free(empty_cells_array);
 
+	if(successful==FALSE || successful==CANCELLED)
+	{
+		if(successful==CANCELLED)
+		{
+			print_timed_out();
+		}
+		else if(solvable==FALSE)
+		{
+			print_cant_generate();
+		}
+		else if(solvable==TRUE)
+		{
+			print_too_many_iterations("generate_board");
+		}
+		/*else the solver printed the error*/
+		/*remove the new move we added*/
+		revert_new_move(board, EDIT);
+		free_matrix(prev_cells,length);
+		return;
+	}
+
 	 /*for generate_fixed_cells_from_solution*/
 	board->filled_cells = num_fixed; /*update the amount of cells to be num_fixed*/
 
@@ -201,6 +260,7 @@ void generate(sudoku_board *board, int num_to_fill, int num_fixed)
 	board->cells = make_matrix(length);
 
 	generate_fixed_cells_from_solution(board, prev_cells);/*updates board->cells AND the set list of recent move*/
+	update_pencil_marks(board);
 	free_matrix(prev_cells,length);
 	/*If this line is reached, the board definitely changed*/
 	print_board(board, EDIT);/*generate is only available in Edit mode*/
@@ -224,169 +284,29 @@ BOOL fixed_or_error(sudoku_board *board, int i,int j)
 	 */
 	return get_matrix((board->fixed_or_error),i,j,(board->length));
 }
-static void update_err_row(sudoku_board *board,int row_num, STATUS s)
-{
-	/*
-	 * Marks all errors caused by repeating digits in row row_num (1 to length) as errors, and updates board->num_erros accordingly.
-	 * Assumes row_num is legal and that the board is initialized
-	 * Non erroneous cells will be updated as well
-	 */
-	int i, digit, fixerr ,n;
-	int length = board->length;
-	LINKEDLIST pos;
-	/*an array such that arr[j] contains a list of all column numbers in which the j+1 digit occurs*/
-	LINKEDLIST* arr = calloc(length, sizeof(LINKEDLIST));
-	check_alloc(arr, "update_err_row");
-
-	for(i = 1; i <= length; i++)
-	{
-		digit = board->cells[i-1][row_num-1];
-		if(digit>0)/*we don't care about empty cells*/
-		{
-			appendToLinkedList(arr+digit-1,i);/*adds the index i to the linked list of the corresponding digit*/
-		}
-		else/*empty cell*/
-		{
-			if(fixed_or_error(board,i,row_num)==2) /*empty cells should not be erroneous*/
-			{
-				board->fixed_or_error[i-1][row_num-1] = 0;
-				board->num_errors--;
-			}
-		}
-	}
-
-	for(digit = 1; digit <= length; digit++)
-	{
-		pos = arr[digit-1];
-		n = getLength(pos);
-		if(n>1) /*multiple occurrences of a digit is an error for each*/
-		{
-			while(pos!=NULL)
-			{
-				i = pos->data;
-				fixerr = fixed_or_error(board,i,row_num);
-				if(fixerr == 0 || (fixerr == 1 && s == EDIT)) /*there is an unmarked error on a non-fixed cell, mark it*/
-				{
-					board->fixed_or_error[i-1][row_num-1] = 2;
-					board->num_errors++;
-				}
-				pos = pos->next;
-			}
-
-		}
-		else if (n==1)
-		{
-			i = pos->data;
-			/*we still need to make sure the value is indeed legal because it might be erroneous due to column or block*/
-			fixerr = fixed_or_error(board,i,row_num);
-			if((fixerr==2) && is_legal(board,i,row_num,digit,FALSE)) /*cell marked as erroneous but isn't*/
-			{
-				board->fixed_or_error[i-1][row_num-1] = 0;
-				board->num_errors--;
-			}
-		}
-		destroyLinkedList(arr[digit-1]);
-	}
-	free(arr);
-}
-
-static void update_err_column(sudoku_board *board,int column_num, STATUS s)
-{
-	/*
-	 * Marks all errors caused by repeating digits in column column_num (1 to length) as errors, and updates board->num_erros accordingly.
-	 * Assumes row_num is legal and that the board is initialized
-	 * Non erroneous cells will be updated as well
-	 */
-	int j, digit, fixerr ,n;
-	int length = board->length;
-	LINKEDLIST pos;
-	/*an array such that arr[i] contains a list of all row numbers in which the i+1 digit occurs*/
-	LINKEDLIST* arr = calloc(length, sizeof(LINKEDLIST));
-	check_alloc(arr,"update_err_column");
-
-	for(j = 1; j <= length; j++)
-	{
-		digit = board->cells[column_num-1][j-1];
-		if(digit>0)/*we don't care about empty cells*/
-		{
-			appendToLinkedList(arr+digit-1,j);/*adds the index j to the linked list of the corresponding digit*/
-		}
-		else/*empty cell*/
-		{
-			if(fixed_or_error(board,column_num,j)==2) /*empty cells should not be erroneous*/
-			{
-				board->fixed_or_error[column_num-1][j-1] = 0;
-				board->num_errors--;
-			}
-		}
-	}
-
-	for(digit = 1; digit <= length; digit++)
-	{
-		pos = arr[digit-1];
-		n = getLength(pos);
-		if(n>1) /*multiple occurrences of a digit is an error for each*/
-		{
-			while(pos!=NULL)
-			{
-				j = pos->data;
-				fixerr = fixed_or_error(board,column_num,j);
-				if(fixerr == 0 || (fixerr == 1 && s == EDIT)) /*there is an unmarked error on a non-fixed cell, mark it*/
-				{
-					board->fixed_or_error[column_num-1][j-1] = 2;
-					board->num_errors++;
-				}
-				pos = pos->next;
-			}
-
-		}
-		else if (n==1)
-		{
-			j = pos->data;
-			/*we still need to make sure the value is indeed legal because it might be erroneous due to row or block*/
-			fixerr = fixed_or_error(board,column_num,j);
-			if((fixerr==2) && is_legal(board,column_num,j,digit,FALSE)) /*cell marked as erroneous but isn't*/
-			{
-				board->fixed_or_error[column_num-1][j-1] = 0;
-				board->num_errors--;
-			}
-		}
-		destroyLinkedList(arr[digit-1]);
-	}
-	free(arr);
-
-}
-
-static void update_err_block(sudoku_board *board,int column_num ,int row_num, STATUS s)
+static void update_err_group(sudoku_board *board, int group, STATUS s)
 {
 	/*
-	 * Marks all errors caused by repeating digits in block that has at [column_num,row_num] as errors, and updates board->num_erros accordingly.
-	 * Assumes row_num is legal and that the board is initialized
+	 * Marks all errors caused by repeating digits in group group (see groups.h) as errors, and updates board->num_erros accordingly.
+	 * Assumes group is legal and that the board is initialized
 	 * Non erroneous cells will be updated as well
 	 */
-	int I,J,i,j,k, digit, fixerr ,n;
+	int i, j, k, digit, fixerr ,n;
 	int length = board->length;
-	int hor = board->block_horizontal;
-	int ver = board->block_vertical;
-
+	int *cells = board->groups->cells + group*length;
 	LINKEDLIST pos;
-	/*an array such that arr[l] contains a list of all row numbers in which the l+1 digit occurs*/
+	/*an array such that arr[l] contains a list of all the positions in the group in which the l+1 digit occurs*/
 	LINKEDLIST* arr = calloc(length, sizeof(LINKEDLIST));
-
-	I = ((column_num-1)/hor)*hor+1; /*indices of beginning of th block*/
-	J = ((row_num-1)/ver)*ver+1;
-
-	check_alloc(arr,"update_err_row");
+	check_alloc(arr,"update_err_group");
 
 	for(k = 0; k < length; k++)
 	{
-		i = I+k%hor;
-		j = J + k/hor;
-		/*printf("%d %d\n",i,j);*/
+		i = cells[k]%length + 1;
+		j = cells[k]/length + 1;
 		digit = board->cells[i-1][j-1];
 		if(digit>0)/*we don't care about empty cells*/
 		{
-			appendToLinkedList(arr+digit-1,k);/*adds the index j to the linked list of the corresponding digit*/
+			appendToLinkedList(arr+digit-1,k);/*adds the index k to the linked list of the corresponding digit*/
 		}
 		else/*empty cell*/
 		{
@@ -407,8 +327,8 @@ static void update_err_block(sudoku_board *board,int column_num ,int row_num, ST
 			while(pos!=NULL)
 			{
 				k = pos->data;
-				i = I+k%hor;
-				j = J + k/hor;
+				i = cells[k]%length + 1;
+				j = cells[k]/length + 1;
 				fixerr = fixed_or_error(board,i,j);
 				if(fixerr == 0 || (fixerr == 1 && s == EDIT)) /*there is an unmarked error on a non-fixed cell, mark it*/
 				{
@@ -422,9 +342,9 @@ static void update_err_block(sudoku_board *board,int column_num ,int row_num, ST
 		else if (n==1)
 		{
 			k = pos->data;
-			i = I+k%hor;
-			j = J + k/ver;
-			/*we still need to make sure the value is indeed legal because it might be erroneous due to row or block*/
+			i = cells[k]%length + 1;
+			j = cells[k]/length + 1;
+			/*we still need to make sure the value is indeed legal because it might be erroneous due to another group*/
 			fixerr = fixed_or_error(board,i,j);
 			if((fixerr==2) && is_legal(board,i,j,digit,FALSE)) /*cell marked as erroneous but isn't*/
 			{
@@ -435,17 +355,21 @@ static void update_err_block(sudoku_board *board,int column_num ,int row_num, ST
 		destroyLinkedList(arr[digit-1]);
 	}
 	free(arr);
-
 }
 
 void update_err_changed_cell(sudoku_board *board, int i, int j,STATUS s)
 {
 	/*
-	 * updates all erroneous values that might have changed due to updating the (i-1,j-1) cell
+	 * updates all erroneous values that might have changed due to updating the (i-1,j-1) cell:
+	 * the values of every group of the cell
 	 */
-	update_err_row(board,j,s);
-	update_err_column(board,i,s);
-	update_err_block(board,i,j,s);
+	group_table *groups = board->groups;
+	int cell = (i-1) + (j-1)*board->length;
+	int k;
+	for(k = groups->first_group[cell]; k < groups->first_group[cell+1]; k++)
+	{
+		update_err_group(board,groups->groups_of[k],s);
+	}
 }
 
 BOOL set(sudoku_board *board, int i, int j, int value, STATUS status)
@@ -462,7 +386,6 @@ BOOL set(sudoku_board *board, int i, int j, int value, STATUS status)
 	 * board.num_errors to the new number of errors.
 	 * recent_move to this set move and destroys any move that was after recent_move before this command was called.
 	 */
-	int **M = board->cells;
 	int length = board->length;
 	BOOL last_cell_filled;/*, legal_i_j;*/
 	int last_value = get(board,i,j);
@@ -481,7 +404,7 @@ BOOL set(sudoku_board *board, int i, int j, int value, STATUS status)
 		}
 	}
 
-	M[i-1][j-1] = value;
+	write_cell(board, i, j, value);
 
 	update_err_changed_cell(board, i, j, status);
 	print_board(board,status);
@@ -617,120 +540,53 @@ void print_board(sudoku_board *board, STATUS status)
 	free(separator_row);
 }
 
-static LINKEDLIST get_block(sudoku_board *board, int **M, int i, int j)
-{
-	/*
-	 * returns a LINKEDLIST of all values in the block containing the (i-1,j-1) cell in board, excluding that cell.
-	 * If board is NULL returns NULL.
-	 * Assumes board is initialized.
-	 */
-	int length,I,J, vert,hort, temp;
-	int l,m; /*loop indices*/
-	LINKEDLIST block = NULL; /*the return-to-be value*/
-	if(board == NULL)
-	{
-		printf("get_block NULL\n");
-		return NULL;
-	}
-
-	length = board->length;
-
-	hort = board->block_horizontal;
-	vert = board->block_vertical;
-
-	I = (i-1)/(hort); /*the vertical coordinate representing the block (there are block_horizontal of those)*/
-	J = (j-1)/(vert); /*the horizontal coordinate representing the block (there are block_vertical of those)*/
-	for(l = 1; l <= vert; l++)
-	{
-		for(m = 1; m <= hort; m++)
-		{
-			if( (m+I*hort == i) && (l+J*vert == j) )
-			{
-				continue;
-			}
-			temp = get_matrix(M,m+I*hort,l+J*vert,length);
-			if(temp!=0)
-			{
-				appendToLinkedList(&block, temp); /*adds all cells in the block to the return list "block"*/
-			}
-		}
-	}
-	return block;
-}
-
-static LINKEDLIST get_column(sudoku_board *board, int **M, int i, int row)
-{
-	/*
-	 * returns a LINKEDLIST of all values in i-1 row in board, excluding the one at row 'row' .
-	 * If board is NULL returns NULL.
-	 * Assumes board is initialized.
-	 */
-	int j, length, temp;
-	LINKEDLIST column = NULL;
-	if(board == NULL)
-	{
-		return NULL;
-	}
-
-	length = board->length;
-
-	for(j = 1; j <= length; j++)
-	{
-		if(j != row)
-		{
-			temp = get_matrix(M, i, j,length);
-			if(temp!=0)
-			{
-				appendToLinkedList(&column, temp);
-			}
-		}
-	}
-	return column;
-}
-
-static LINKEDLIST get_row(sudoku_board *board,int **M, int column ,int j)
+static LINKEDLIST get_group(sudoku_board *board, int **M, int group, int cell)
 {
 	/*
-	 * returns a LINKEDLIST of all values in j-1 row in board, excluding the one at column 'column' .
+	 * returns a LINKEDLIST of all values of M in group group of board (see groups.h), excluding the one at cell.
 	 * If board is NULL returns NULL.
 	 * Assumes board is initialized.
 	 */
-	int i, length, temp;
-	LINKEDLIST row = NULL;
+	int k, length, temp;
+	int *cells;
+	LINKEDLIST values = NULL;
 	if(board == NULL)
 	{
 		return NULL;
 	}
 
 	length = board->length;
-	for(i = 1; i <= length; i++)
+	cells = board->groups->cells + group*length;
+	for(k = 0; k < length; k++)
 	{
-		if(i != column)
+		if(cells[k] != cell)
 		{
-			temp = get_matrix(M, i, j,length);
+			temp = get_matrix(M, cells[k]%length + 1, cells[k]/length + 1, length);
 			if(temp!=0)
 			{
-				appendToLinkedList(&row, temp);
+				appendToLinkedList(&values, temp);
 			}
 		}
 	}
-	return row;
+	return values;
 }
 
 static LINKEDLIST get_neighbors(sudoku_board *board, int **M, int i, int j)
 {
 	/*
-	 * returns a linked list of all neighbors in the j row, i column of M, and the block containing the (i-1,j-1) element.
-	 * if one of the values given is illegal, returns an empty list.
+	 * returns a linked list of all neighbors of the (i-1,j-1) element of M: the values in every group of the cell
+	 * (its row, column and region, and the extra groups of the variant that it is in).
 	 * Need to not include the said cell.
 	 */
-	LINKEDLIST row,column,block;
-	row = get_row(board, M ,i, j);
-	column = get_column(board, M, i, j);
-	block = get_block(board, M, i, j);
-	linkedListUnion(&row,column); /* "row += column" */
-	linkedListUnion(&block,row); /* "block += row" */
-	return block;
+	group_table *groups = board->groups;
+	int cell = (i-1) + (j-1)*board->length;
+	int k;
+	LINKEDLIST neighbors = NULL;
+	for(k = groups->first_group[cell]; k < groups->first_group[cell+1]; k++)
+	{
+		linkedListUnion(&neighbors,get_group(board, M, groups->groups_of[k], cell)); /* "neighbors += group" */
+	}
+	return neighbors;
 }
 
 BOOL is_legal(sudoku_board *board, int i, int j, int value,BOOL sol)
@@ -740,9 +596,14 @@ BOOL is_legal(sudoku_board *board, int i, int j, int value,BOOL sol)
 	 * Return True iff "value" is a legal value for column i row j of board (meaning it is different from all neighbors).
 	 * If sol is TRUE:
 	 * Return True iff "value" is a legal value for column i row j of board.solution (meaning it is different from all neighbors).
+	 * The cells of a played board are looked up in its pencil marks (see pencil.h).
 	 */
 	LINKEDLIST neighbors;
 	BOOL result;
+	if(!sol && board->marks != NULL)
+	{
+		return (get_pencil_marks(board,i,j) & DIGIT_BIT(value)) != 0;
+	}
 	if(sol)
 	{
 		neighbors = get_neighbors(board,board->solution, i, j);
@@ -761,10 +622,24 @@ LINKEDLIST get_legal_values(sudoku_board *board, int i, int j,BOOL sol)
 {
 	/*
 	 * Returns a LINKEDLIST of legal values for the cell at row i-1 and column j-1.
+	 * The cells of a played board are looked up in its pencil marks (see pencil.h).
 	 */
 	LINKEDLIST neighbors;
 	LINKEDLIST result = NULL;
+	MASK legal;
 	int k;
+	if(!sol && board->marks != NULL)
+	{
+		legal = get_pencil_marks(board,i,j);
+		for(k=1; k<=board->length; k++)
+		{
+			if(legal & DIGIT_BIT(k))
+			{
+				appendToLinkedList(&result,k);
+			}
+		}
+		return result;
+	}
 	/*printf("getting neighbors\n");*/ /*debug*/
 	if(sol)
 	{
@@ -785,22 +660,94 @@ LINKEDLIST get_legal_values(sudoku_board *board, int i, int j,BOOL sol)
 			/*printf("complete\n");*/
 		}
 	}
+	destroyLinkedList(neighbors);
 	return result;
 }
 
+void show_candidates(sudoku_board *board, int x, int y)
+{
+	/*
+	 * Prints the legal values of column x and row y of the board, the digits that no other cell of one of its groups holds,
+	 * from the pencil marks of the board. The cell may be filled.
+	 * Assumes the mode is Edit or Solve.
+	 */
+	MASK legal = get_pencil_marks(board,x,y);
+	int digit;
+	if(legal == 0)
+	{
+		printf("Cell (%d,%d) has no legal values.\n",x,y);
+		return;
+	}
+	printf("Candidates of cell (%d,%d):",x,y);
+	for(digit = 1; digit <= board->length; digit++)
+	{
+		if(legal & DIGIT_BIT(digit))
+		{
+			printf(" %d",digit);
+		}
+	}
+	printf("\n");
+}
+
+static BOOL find_cached_solution(sudoku_board *board, solve_cache *cache)
+{
+	/*
+	 * Makes cache, the solve cache of the cells of board, know whether they are solvable,
+	 * which is only solved with solve_board if it isn't known yet and the stored solution doesn't solve them.
+	 * Returns TRUE if the board is solvable: cache->solution holds a solution, which is also stored in board->solution.
+	 * Returns FALSE if it is unsolvable, ERROR or CANCELLED like solve_board.
+	 */
+	cancel_token *token;
+	BOOL solution_found = cache->solvable;
+
+	if(solution_found==ERROR && solution_fits_board(board))
+	{/*the cells changed without moving away from the stored solution*/
+		remember_solution(cache,board->solution);
+		solution_found = TRUE;
+	}
+	if(solution_found==ERROR)
+	{
+		token = new_command_token();
+		solution_found = solve_board(board,token);
+		free_cancel_token(token);
+		if(solution_found==TRUE)
+		{
+			remember_solution(cache,board->solution);
+		}
+		else if(solution_found==FALSE)
+		{
+			remember_unsolvable(cache);
+		}
+	}
+	else if(solution_found==TRUE)
+	{
+		copy_matrix(cache->solution,board->solution,board->length);
+	}
+	return solution_found;
+}
+
 BOOL validate(sudoku_board *board)
 {
 	/*
-	 * Validates that the current state of the board is solvable using ILP.
+	 * Validates that the current state of the board is solvable using solve_board.
 	 * Returns and prints if validation passed(TRUE) or failed(FALSE).
 	 * If validation passed, updates the stored solution of board.
+	 * Returns CANCELLED and prints it if validation ran out of its time budget.
 	 * Assumes the mode is Edit or Solve and that the board is not erroneous.
+	 * The board isn't solved again if the solve cache knows the answer for its cells,
+	 * or if the stored solution still solves them.
 	 */
-	BOOL solution_found = solve_board(board);
+	BOOL solution_found = find_cached_solution(board,get_solve_cache(board));
+
 	if(solution_found==ERROR)
 	{/*the solver printed the error*/
 		return(ERROR);
 	}
+	if(solution_found==CANCELLED)
+	{
+		print_timed_out();
+		return(CANCELLED);
+	}
 	if(solution_found==TRUE)
 	{
 		printf("Validation passed: board is solvable.\n");
@@ -813,20 +760,61 @@ BOOL validate(sudoku_board *board)
 	}
 }
 
+static BOOL find_cached_backbone(sudoku_board *board, solve_cache *cache)
+{
+	/*
+	 * Makes cache, the solve cache of the cells of board, hold their backbone (see find_backbone),
+	 * which is only searched for if it isn't known yet.
+	 * Returns TRUE if the board is solvable: cache->forced holds the backbone, and cache->solution a solution,
+	 * which is also stored in board->solution. Returns FALSE if it is unsolvable, ERROR or CANCELLED like find_backbone.
+	 */
+	cancel_token *token;
+	int **forced;
+	BOOL boardSolvable = cache->solvable;
+	if(cache->forced == NULL && boardSolvable != FALSE)
+	{
+		token = new_command_token();
+		forced = make_matrix(board->length);
+		boardSolvable = find_backbone(board,forced,token);
+		if(boardSolvable==TRUE)
+		{
+			remember_backbone(cache,forced,board->solution);
+		}
+		else if(boardSolvable==FALSE)
+		{
+			remember_unsolvable(cache);
+		}
+		free_matrix(forced,board->length);
+		free_cancel_token(token);
+	}
+	else if(boardSolvable==TRUE)
+	{
+		copy_matrix(cache->solution,board->solution,board->length);
+	}
+	return boardSolvable;
+}
+
 void hint(sudoku_board *board, int i,int j)
 {
 	/*
-	 * Runs ILP to solve the board. If the board is unsolvable prints an error message.
+	 * Runs solve_board to solve the board. If the board is unsolvable prints an error message.
 	 * Else, prints to the user the value at column i and row j of the solution.
 	 * Assumes the mode is Solve, the board is not erroneous,
 	 * cell <i,j> is not fixed and doesn't contain a value.
+	 * The board isn't solved again if the solve cache knows the answer for its cells,
+	 * or if the stored solution still solves them.
 	 */
-	BOOL boardSolvable = solve_board(board);
+	BOOL boardSolvable = find_cached_solution(board,get_solve_cache(board));
 	int hint_digit;
 	if(boardSolvable==ERROR)
 	{/*The solver printed the error*/
 		return;
 	}
+	if(boardSolvable==CANCELLED)
+	{
+		print_timed_out();
+		return;
+	}
 	if(boardSolvable==FALSE)
 	{
 		printf("Error: Board is unsolvable, can't hint.\n");
@@ -856,6 +844,50 @@ void set_mark_errors(int x)
 	mark_errors = x;
 }
 
+void set_monitor(int x)
+{
+	/*
+	 * Sets the global parameter "monitor_solvability" to x.
+	 * Assumes x is 1 or 0.
+	 */
+	monitor_solvability = x;
+}
+
+const char* get_solvability_flag(sudoku_board *board, STATUS s)
+{
+	/*
+	 * Returns the flag the prompt shows for board: " (solvable)", " (unsolvable)", or " (undecided)" when the check
+	 * gave up, from check_solvability. Returns "" if the monitor is off or the mode isn't Solve.
+	 * Checks the board every time it is called, so after every set and every other command that changes the board.
+	 */
+	int result;
+	if(monitor_solvability==0 || s!=SOLVE)
+	{
+		return "";
+	}
+	result = check_solvability(board);
+	if(result==TRUE)
+	{
+		return " (solvable)";
+	}
+	if(result==FALSE)
+	{
+		return " (unsolvable)";
+	}
+	return " (undecided)";
+}
+
+void set_time_budget(double seconds)
+{
+	/*
+	 * Sets the seconds each of validate, hint, fill_forced, guess, guess_hint, generate, num_solutions, estimate,
+	 * count_symmetric and enumerate may run.
+	 * A command that runs out of its budget prints that it was stopped and leaves the board and the moves unchanged.
+	 * Assumes seconds >= 0, 0 means no limit.
+	 */
+	time_budget = seconds;
+}
+
 static double* get_high_scores_for_cell(double* scores3Dmat,int length,int i,int j,double X)
 {
 	/*
@@ -972,17 +1004,25 @@ BOOL guess(sudoku_board *board, float X)
 	double* scores3Dmat; /*a flattened 3D matrix of the LP solution to the board*/
 	double* cell_high_scores; /*an array of the values and scores of a cell*/
 	BOOL board_has_changed = FALSE;
+	cancel_token *token = new_command_token();
+	int status; /*what the LP ended with, see get_LP_scores*/
 
 	/*creating a new move*/
 	sprintf(command_info, "guess %f", X);
 	append_new_move(command_info);
 
 	/*Getting the scores from LP*/
-	scores3Dmat = get_LP_scores(board);
+	scores3Dmat = get_scores(board,&status,token);
+	free_cancel_token(token);
 	if(scores3Dmat==NULL)
-	{/*the board is not solvable or Gurobi encountered an error*/
+	{/*the board is not solvable, Gurobi encountered an error or the time budget ran out*/
 		revert_new_move(board, SOLVE);
-		if(get_error_status()==TRUE)
+		if(status==CANCELLED)
+		{
+			print_timed_out();
+			return FALSE;
+		}
+		if(status==ERROR)
 		{/*encountered an error. Gurobi printed the error message*/
 			return ERROR;
 		}
@@ -1009,7 +1049,7 @@ BOOL guess(sudoku_board *board, float X)
 				ne_val = choose_val_acc_score(cell_high_scores);
 				if(is_legal(board,i,j,ne_val,FALSE)==TRUE)
 				{/*don't fill illegal values created along the way*/
-					(board->cells)[i-1][j-1] = ne_val;
+					write_cell(board, i, j, ne_val);
 					board->filled_cells++;
 					append_ijval_to_recent_move(i,j,prev_val,ne_val);
 					board_has_changed = TRUE;
@@ -1108,9 +1148,10 @@ void save(sudoku_board *board, STATUS s, FILE *f)
 	 * Saves the current game board to the specified file f, according to the file format in page 13 in the pdf.
 	 * Assumes f points to an existing valid file, the mode is right and the board is valid.
 	 * In Edit mode, cells containing values are marked as "fixed" in the saved file.
+	 * The words of the variant of the board and its cages follow the cells, see load_puzzle_from_file.
 	 * Prints that the board was successfully saved.
 	 */
-	int i,j,length, val;
+	int i,j,length, val, cage, k;
 	length = board->length;
 	fprintf(f,"%d %d\n",board->block_vertical,board->block_horizontal);
 	for(j = 1; j <= length; j++)
@@ -1130,6 +1171,34 @@ void save(sudoku_board *board, STATUS s, FILE *f)
 		}
 		fwrite("\n",sizeof(char),1,f);
 	}
+	if(board->variant & DIAGONAL_GROUPS)
+	{
+		fprintf(f,"diagonal\n");
+	}
+	if(board->variant & WINDOKU_GROUPS)
+	{
+		fprintf(f,"windoku\n");
+	}
+	if(!are_blocks(board))
+	{
+		fprintf(f,"jigsaw\n");
+		for(j = 1; j <= length; j++)
+		{
+			for(i = 1; i <= length; i++)
+			{
+				fprintf(f,(i<length) ? "%d " : "%d\n",board->region[i-1][j-1]+1);
+			}
+		}
+	}
+	for(cage = 0; board->cages != NULL && cage < board->cages->num_cages; cage++)
+	{
+		fprintf(f,"cage %d %d",board->cages->sum[cage],board->cages->first_cell[cage+1] - board->cages->first_cell[cage]);
+		for(k = board->cages->first_cell[cage]; k < board->cages->first_cell[cage+1]; k++)
+		{
+			fprintf(f," %d %d",board->cages->cells[k]%length + 1,board->cages->cells[k]/length + 1);
+		}
+		fprintf(f,"\n");
+	}
 	printf("File saved successfully.\n");
 	return;
 }
@@ -1147,12 +1216,20 @@ void guess_hint(sudoku_board *board, int x, int y)
 	double* scores3Dmat; /*a flattened 3D matrix of the LP solution to the board*/
 	double* cell_high_scores; /*an array of the values and scores of a cell*/
 	double score;
+	cancel_token *token = new_command_token();
+	int status; /*what the LP ended with, see get_LP_scores*/
 
 	/*Getting the scores from LP*/
-	scores3Dmat = get_LP_scores(board);
+	scores3Dmat = get_scores(board,&status,token);
+	free_cancel_token(token);
 	if(scores3Dmat==NULL)
-	{/*the board is not solvable or Gurobi encountered an error*/
-		if(get_error_status()==TRUE)
+	{/*the board is not solvable, Gurobi encountered an error or the time budget ran out*/
+		if(status==CANCELLED)
+		{
+			print_timed_out();
+			return;
+		}
+		if(status==ERROR)
 		{/*encountered an error. Gurobi printed the error message*/
 			return;
 		}
@@ -1181,19 +1258,166 @@ void guess_hint(sudoku_board *board, int x, int y)
 
 }
 
-void num_solutions(sudoku_board *board)
+void num_solutions(sudoku_board *board, int limit)
 {
 	/*
 	 * Runs an exhaustive backtracking algorithm for the current board to find how many solutions
 	 * there are, and then prints the result.
+	 * If limit is not NO_LIMIT, the search stops after limit solutions.
+	 * Without a limit, a board with INT_MAX solutions or more is counted again with count_solutions_exact,
+	 * so counts that don't fit in an int are printed exactly.
+	 * Prints that the command was stopped if it ran out of its time budget.
+	 * The board isn't counted again if the solve cache knows the count for its cells.
+	 */
+	cancel_token *token = new_command_token();
+	solve_cache *cache = get_solve_cache(board);
+	int count = get_cached_count(cache,limit);
+	bigint *total;
+	char *total_str;
+
+	if(count == ERROR)
+	{
+		count = count_solutions_bounded(board,limit,token);
+		if(count != CANCELLED)
+		{
+			remember_count(cache,count,limit);
+		}
+	}
+	if(limit == NO_LIMIT && count == INT_MAX && cache->total == NULL)
+	{/*the count stopped at the largest int, count again with no bound*/
+		total = new_bigint(0);
+		if(count_solutions_exact(board,total,token) == CANCELLED)
+		{
+			count = CANCELLED;
+		}
+		else
+		{
+			total_str = bigint_to_string(total);
+			remember_total(cache,total_str);
+			free(total_str);
+		}
+		free_bigint(total);
+	}
+	free_cancel_token(token);
+	if(count == CANCELLED)
+	{
+		print_timed_out();
+	}
+	else if(limit == NO_LIMIT && count == INT_MAX)
+	{
+		printf("Exhaustive Backtracking complete. %s solutions found.\n",cache->total);
+	}
+	else if(limit != NO_LIMIT && count == limit)
+	{
+		printf("Exhaustive Backtracking stopped. At least %d solution%s found.\n",count,(count==1) ? "" : "s");
+	}
+	else
+	{
+		printf("Exhaustive Backtracking complete. %d solutions found.\n",count);
+	}
+}
+
+void estimate(sudoku_board *board, double seconds)
+{
+	/*
+	 * Estimates the number of solutions of the current board with random probes of its search tree
+	 * for the given seconds (see estimate_solutions), and prints the estimate with its 95% confidence interval.
+	 * A board that is quick to count is counted exactly instead.
+	 * The time budget of the commands still applies, so the estimate stops at whichever ends first.
+	 * Prints that the command was stopped if no probe ended in time.
+	 * Assumes the mode is Edit or Solve, the board is not erroneous and seconds > 0.
 	 */
-	printf("Exhaustive Backtracking complete. %d solutions found.\n",exhaustive_backtracking(board));
+	cancel_token *command_token = new_command_token();
+	cancel_token *token = new_cancel_token(command_token);
+	count_estimate result;
+	BOOL solvable;
+
+	set_deadline(token,seconds);
+	solvable = estimate_solutions(board,&result,token);
+	free_cancel_token(token);
+	free_cancel_token(command_token);
+	if(solvable == CANCELLED)
+	{
+		print_timed_out();
+	}
+	else if(solvable == FALSE)
+	{
+		printf("Estimation complete. The board has no solutions.\n");
+	}
+	else if(result.exact)
+	{
+		printf("Estimation complete. The board was counted exactly: %.0f solutions.\n",result.estimate);
+	}
+	else
+	{
+		printf("Estimation complete. About %.4g solutions (95%% confidence interval %.4g to %.4g, from %d probe%s).\n",
+				result.estimate,result.low,result.high,result.num_probes,(result.num_probes==1) ? "" : "s");
+	}
+}
+
+void count_symmetric(sudoku_board *board)
+{
+	/*
+	 * Counts the solutions of the current board exactly, with no limit on their number, by counting one of every
+	 * orbit of symmetric solutions (see symmetry.h), and prints the result and the number of symmetries divided out.
+	 * Prints that the command was stopped if it ran out of its time budget.
+	 * Assumes the mode is Edit or Solve and the board is not erroneous.
+	 */
+	cancel_token *token = new_command_token();
+	bigint *total = new_bigint(0);
+	bigint *symmetries = new_bigint(1);
+	char *total_str, *symmetries_str;
+
+	if(count_solutions_symmetric(board,total,symmetries,token) == CANCELLED)
+	{
+		print_timed_out();
+	}
+	else
+	{
+		total_str = bigint_to_string(total);
+		symmetries_str = bigint_to_string(symmetries);
+		printf("Symmetric counting complete. %s solutions found, counting one of every %s symmetric solutions.\n",
+				total_str,symmetries_str);
+		free(total_str);
+		free(symmetries_str);
+	}
+	free_cancel_token(token);
+	free_bigint(total);
+	free_bigint(symmetries);
+}
+
+void enumerate(sudoku_board *board, FILE *f, BOOL delta)
+{
+	/*
+	 * Writes every solution of the current board to the file f, opened for binary writing,
+	 * in the format of solution_writer.h (delta encoded if delta is TRUE), and prints how many were written.
+	 * If the command runs out of its time budget, the solutions found until then are in the file.
+	 * Assumes the mode is Edit or Solve and the board is not erroneous.
+	 */
+	cancel_token *token = new_command_token();
+	solution_writer *writer = new_solution_writer(f,board,delta);
+	int count = enumerate_solutions(board,write_solution,writer,token);
+	int written = get_solutions_written(writer);
+
+	free_cancel_token(token);
+	if(!close_solution_writer(writer))
+	{
+		print_fwrite_error();
+		return;
+	}
+	if(count == CANCELLED)
+	{
+		print_timed_out();
+		printf("%d solution%s written before the enumeration stopped.\n",written,(written==1) ? " was" : "s were");
+		return;
+	}
+	printf("Enumeration complete. %d solution%s written.\n",written,(written==1) ? "" : "s");
 }
 
 static void init_board(sudoku_board *board, int block_horizontal, int block_vertical)
 {
 	/*
-	 * Initializes the board state to be workable.
+	 * Initializes the board state to be workable, as a regular sudoku board (its regions are its blocks).
 	 * Assumes board is not NULL. If isInit, frees the memory.
 	 */
 	int length = block_horizontal * block_vertical;
@@ -1204,6 +1428,12 @@ static void init_board(sudoku_board *board, int block_horizontal, int block_vert
 		free_matrix(board->cells,prev_length);
 		free_matrix(board->solution,prev_length);
 		free_matrix(board->fixed_or_error,prev_length);
+		free_matrix(board->region,prev_length);
+		free_group_table(board->groups);
+		free_cage_table(board->cages);
+		free_pencil_marks(board->marks);
+		free_candidates(board->monitor);
+		free_solve_cache(board->cache);
 		/*printf("done\n");*/
 	}
 	board->block_horizontal = block_horizontal;
@@ -1212,6 +1442,16 @@ static void init_board(sudoku_board *board, int block_horizontal, int block_vert
 	board->cells = make_matrix(length);
 	board->solution = make_matrix(length);
 	board->fixed_or_error = make_matrix(length);
+	board->region = make_matrix(length);
+	set_block_regions(board);
+	board->variant = 0;
+	board->groups = NULL;
+	update_groups(board);
+	board->cages = NULL;
+	board->marks = NULL;
+	update_pencil_marks(board);
+	board->monitor = NULL;
+	board->cache = NULL;
 	board->filled_cells = 0;
 	board->num_errors = 0;
 	board->isInit = TRUE;
@@ -1223,29 +1463,99 @@ void update_err_board(sudoku_board *board, STATUS s)
 	 * Updates the erroneous markings over all of the board.
 	 * Assumes board is initialized.
 	 */
-	int i,j,length,hor,ver;
-
-	length = board->length;
-	hor = board->block_horizontal;
-	ver = board->block_vertical;
+	int group;
 
-	for(j = 1; j <= length; j++)
-	{
-		update_err_row(board, j, s); /*updates all rows*/
-	}
-
-	for(i = 1; i <= length; i++)
+	for(group = 0; group < board->groups->num_groups; group++)
 	{
-		update_err_column(board, i, s); /*updates all columns*/
+		update_err_group(board, group, s); /*updates all rows, columns, regions and extra groups*/
 	}
+}
 
-	for(j = 1; j <= length; j+=ver) /*we only want the first entry of each block*/
+static BOOL load_variant(sudoku_board *board, FILE *file)
+{
+	/*
+	 * Reads the words that may follow the cells of a puzzle file and sets the regions and the variant of board.
+	 * "diagonal" adds the two main diagonals as groups, "windoku" adds the windows between the blocks,
+	 * and "jigsaw" is followed by length*length region numbers (1 to length, in the order of the cells)
+	 * that replace the blocks. "cage" is followed by the sum and the number of cells of a killer cage and then
+	 * the column and the row of each of its cells.
+	 * Any other word is ignored with a warning, like any information after the cells.
+	 * Assumes board->region holds the blocks, board->variant is 0 and board->cages is NULL.
+	 * Returns FALSE (and prints an error) if the regions or a cage are illegal, TRUE otherwise.
+	 */
+	char str[1024];
+	int length = board->length;
+	int i, j, k, region, sum, size;
+	int *cells;
+	while(fscanf(file,"%1023s",str)>0)
 	{
-		for(i = 1; i <= length; i+=hor)  /*we only want the first entry of each block*/
+		if(strcmp(str,"diagonal")==0)
+		{
+			board->variant |= DIAGONAL_GROUPS;
+		}
+		else if(strcmp(str,"windoku")==0)
 		{
-			update_err_block(board, i, j, s); /*updates all blocks*/
+			board->variant |= WINDOKU_GROUPS;
+		}
+		else if(strcmp(str,"jigsaw")==0)
+		{
+			for(j = 1; j <= length; j++)
+			{
+				for(i = 1; i <= length; i++)
+				{
+					if(fscanf(file,"%d",&region)<1 || region<1 || region>length)
+					{
+						printf("Error: The region of cell (%d,%d) is missing or illegal. Reverting to previous board.\n",i,j);
+						return FALSE;
+					}
+					board->region[i-1][j-1] = region-1;
+				}
+			}
+			if(!are_regions_legal(board))
+			{
+				printf("Error: Every region must have exactly %d cells. Reverting to previous board.\n",length);
+				return FALSE;
+			}
+		}
+		else if(strcmp(str,"cage")==0)
+		{
+			if(fscanf(file,"%d %d",&sum,&size)<2 || size<1 || size>length)
+			{
+				printf("Error: A cage has a missing or illegal size. Reverting to previous board.\n");
+				return FALSE;
+			}
+			if(board->cages == NULL)
+			{
+				board->cages = new_cage_table(length);
+			}
+			cells = (int*)malloc(size*sizeof(int));
+			check_alloc(cells,"load_variant");
+			for(k = 0; k < size; k++)
+			{
+				if(fscanf(file,"%d %d",&i,&j)<2 || i<1 || i>length || j<1 || j>length)
+				{
+					printf("Error: A cell of cage %d is missing or illegal. Reverting to previous board.\n",board->cages->num_cages+1);
+					free(cells);
+					return FALSE;
+				}
+				cells[k] = (i-1)+(j-1)*length;
+			}
+			if(!add_cage(board->cages,sum,cells,size))
+			{
+				printf("Error: Cage %d shares a cell with another cage, or no digits add up to its sum. Reverting to previous board.\n",
+						board->cages->num_cages+1);
+				free(cells);
+				return FALSE;
+			}
+			free(cells);
+		}
+		else
+		{
+			printf("Warning: File contains unused information. Loaded board may be incorrect.\n");
+			break;
 		}
 	}
+	return TRUE;
 }
 
 void load_puzzle_from_file(sudoku_board *board, FILE *file, STATUS s)
@@ -1255,18 +1565,20 @@ void load_puzzle_from_file(sudoku_board *board, FILE *file, STATUS s)
 	 * Frees matrices of board if their sizes don't match with the new sizes, and allocates new matrices.
 	 * Uses exit() if encountered a memory allocation error and prints the error message.
 	 * Assumes file is an already opened stream on reading mode. Does not close the stream.
-	 * For practical use, this method will not accept a puzzle with horizontal/vertical block length
-	 * above 5. In this case, a message will be printed and the playing board will stay the same.
+	 * This method will not accept a puzzle with more than MAX_LENGTH values (hor*ver), the largest board
+	 * the solvers support. In this case, a message will be printed and the playing board will stay the same.
+	 * The cells may be followed by the words of a variant, see load_variant.
 	 */
-	int MAX_SIDE_LENGTH = 5;
 	int hor,ver,length,i=1,j=1;
 	char str[1024];
 	char *delim = " \t\r\n";
 	char c;
 	int k, val;
 	/*for saving previous values for reverting in case of error*/
-	int **prev_cells = NULL, **prev_solution = NULL, **prev_fixed_or_error = NULL;
-	int prev_length = 0, prev_hor = 0, prev_ver = 0;
+	int **prev_cells = NULL, **prev_solution = NULL, **prev_fixed_or_error = NULL, **prev_region = NULL;
+	group_table *prev_groups = NULL;
+	cage_table *prev_cages = NULL;
+	int prev_length = 0, prev_hor = 0, prev_ver = 0, prev_variant = 0;
 	int prev_filled_cells = 0, prev_num_errors = 0, prev_isInit = board->isInit;
 	/*variables for the moves list*/
 	doublyLinkedList prev_move_list_head = NULL;
@@ -1282,10 +1594,10 @@ void load_puzzle_from_file(sudoku_board *board, FILE *file, STATUS s)
 		printf("Error: Given board size is illegal. Load failed.\n");
 		return;
 	}
-	if(hor>MAX_SIDE_LENGTH || ver>MAX_SIDE_LENGTH)
+	if(hor>MAX_LENGTH/ver) /*hor*ver>MAX_LENGTH, without overflowing*/
 	{
-		printf("Error: Given board size is not supported. The horizontal and vertical length of blocks\n"
-				"is limited to be %d or lower. Load failed.\n", MAX_SIDE_LENGTH);
+		printf("Error: Given board size is not supported. The number of cells in a block\n"
+				"is limited to be %d or lower. Load failed.\n", MAX_LENGTH);
 		return;
 	}
 	length = hor * ver;
@@ -1307,6 +1619,19 @@ void load_puzzle_from_file(sudoku_board *board, FILE *file, STATUS s)
 		prev_fixed_or_error = make_matrix(prev_length);
 		copy_matrix(board->fixed_or_error, prev_fixed_or_error,prev_length);
 
+		prev_region = make_matrix(prev_length);
+		copy_matrix(board->region, prev_region,prev_length);
+		prev_variant = board->variant;
+		prev_groups = board->groups;
+		board->groups = NULL; /*kept in prev_groups, so it is not freed when the board is initialized*/
+		prev_cages = board->cages;
+		board->cages = NULL; /*kept in prev_cages, like the groups*/
+		/*made for the groups and cages of the previous board, and made again for whichever board is kept*/
+		free_candidates(board->monitor);
+		board->monitor = NULL;
+		free_solve_cache(board->cache);
+		board->cache = NULL;
+
 		/*The previous board is initialized so there is a move list*/
 		prev_move_list_head = move_list_head;
 		prev_recent_move = recent_move;
@@ -1320,18 +1645,15 @@ void load_puzzle_from_file(sudoku_board *board, FILE *file, STATUS s)
 	{
 		board->filled_cells = 0;
 		board->num_errors = 0;
+		set_block_regions(board);
+		board->variant = 0;
 	}
 
 	/*doesn't matter what was the stage of the previous board, we need a new move list*/
 	initialize_move_list();
 
-	while(fscanf(file,"%s",str)>0)
+	while(j<=length && fscanf(file,"%s",str)>0)
 	{
-		if(j>length)
-		{
-			printf("Warning: File contains unused information. Loaded board may be incorrect.\n");
-			break;
-		}
 		for(k = 1; (c=str[k])!='\0'; k++)/*looking to see if cell is fixed*/
 		{
 			if(c=='.')
@@ -1377,11 +1699,20 @@ void load_puzzle_from_file(sudoku_board *board, FILE *file, STATUS s)
 		printf("Error: EOF reached and only %d out of %d cells were filled. Reverting to previous board.\n",(j-1)*length+i-1,length*length);
 		goto REVERT;
 	}
+	if(!load_variant(board,file))
+	{
+		goto REVERT;
+	}
+	update_groups(board);
+	update_pencil_marks(board);
 	/*if we did not revert*/
 	/*free the previous fields because we don't need them*/
 	free_matrix(prev_cells, prev_length);
 	free_matrix(prev_solution, prev_length);
 	free_matrix(prev_fixed_or_error, prev_length);
+	free_matrix(prev_region, prev_length);
+	free_group_table(prev_groups);
+	free_cage_table(prev_cages);
 	free_move_list(prev_move_list_head);
 
 	update_err_board(board,s);
@@ -1395,11 +1726,18 @@ void load_puzzle_from_file(sudoku_board *board, FILE *file, STATUS s)
 	free_matrix(board->cells,length);
 	free_matrix(board->solution,length);
 	free_matrix(board->fixed_or_error,length);
+	free_matrix(board->region,length);
+	free_group_table(board->groups);
+	free_cage_table(board->cages);
 
 	/*re-assignment of the old values*/
 	board->cells = prev_cells;
 	board->solution = prev_solution;
 	board->fixed_or_error = prev_fixed_or_error;
+	board->region = prev_region;
+	board->variant = prev_variant;
+	board->groups = prev_groups;
+	board->cages = prev_cages;
 	board->length = prev_length;
 	board->block_horizontal = prev_hor;
 	board->block_vertical = prev_ver;
@@ -1408,6 +1746,13 @@ void load_puzzle_from_file(sudoku_board *board, FILE *file, STATUS s)
 	board->isInit = prev_isInit;
 	move_list_head = prev_move_list_head;
 	recent_move = prev_recent_move;
+	/*the marks may have been made for the new size, and the cells were written without them*/
+	free_pencil_marks(board->marks);
+	board->marks = NULL;
+	if(board->isInit)
+	{
+		update_pencil_marks(board);
+	}
 }
 
 void edit_no_param(sudoku_board *board)
@@ -1432,6 +1777,63 @@ void edit_no_param(sudoku_board *board)
 	return;
 }
 
+BOOL fill_forced(sudoku_board *board)
+{
+	/*
+	 * Fills every empty cell that has the same value in all the solutions of the board (see find_backbone), as one move.
+	 * Assumes the mode is Solve and the board is not erroneous.
+	 * The method prints the board if the command was executed successfully.
+	 * Returns whether the last cell of the board was filled.
+	 * The backbone is taken from the solve cache when it is known for the cells of the board.
+	 */
+	int length = board->length;
+	solve_cache *cache = get_solve_cache(board);
+	BOOL boardSolvable = find_cached_backbone(board,cache);
+	BOOL board_has_changed = FALSE;
+	int i,j,digit;
+
+	if(boardSolvable!=TRUE)
+	{
+		if(boardSolvable==CANCELLED)
+		{
+			print_timed_out();
+		}
+		else
+		{
+			print_cant_fill_forced();
+		}
+		return FALSE;
+	}
+
+	for(i = 1; i <= length; i++)
+	{
+		for(j = 1; j <= length; j++)
+		{
+			digit = get_matrix(cache->forced,i,j,length);
+			if(get(board,i,j) == 0 && digit != 0)
+			{
+				if(!board_has_changed)
+				{/*only a command that changes the board gets a move*/
+					append_new_move("fill_forced");
+					board_has_changed = TRUE;
+				}
+				append_ijval_to_recent_move(i,j,0,digit);
+				write_cell(board, i, j, digit);
+				board->filled_cells++;
+			}
+		}
+	}
+
+	if(!board_has_changed)
+	{
+		printf("No change: there are no empty cells with the same value in every solution.\n");
+		return FALSE;
+	}
+	update_err_board(board,SOLVE);
+	print_board(board,SOLVE);
+	return board->filled_cells==length*length;
+}
+
 BOOL autofill(sudoku_board *board, STATUS s)
 {
 	/*
@@ -1441,8 +1843,9 @@ BOOL autofill(sudoku_board *board, STATUS s)
 	 * Some cells may be filled with values that are erroneous (two neighbors with the same value).
 	 * Returns whether the last cell of the board was filled.
 	 */
-	LINKEDLIST i_vals,j_vals,digits, legal_vals, posi,posj,posdig;
+	LINKEDLIST i_vals,j_vals,digits, posi,posj,posdig;
 	int i,j,length;
+	MASK legal;
 	BOOL board_has_changed = FALSE;/*change in the board means there was an empty cell that was filled with a non zero value*/
 
 	/*doublyLinkedList tmp;*/ /*that's a surprise tool that will help us later*/
@@ -1461,15 +1864,13 @@ BOOL autofill(sudoku_board *board, STATUS s)
 			if(get(board,i,j) == 0)
 			{
 				/*found an empty cell that can be filled*/
-				legal_vals = get_legal_values(board,i,j,FALSE);
-				if(getLength(legal_vals)==1) /*only one legal value, exactly what we need for autofill*/
+				legal = get_pencil_marks(board,i,j);
+				if(legal!=0 && (legal & (legal-1))==0) /*only one legal value, exactly what we need for autofill*/
 				{
 					/*save the location of that cell and the legal value we want to fill*/
 					appendToLinkedList(&i_vals,i);
 					appendToLinkedList(&j_vals,j);
-					appendToLinkedList(&digits,legal_vals->data); /*the data of the first and only element*/
-
-					destroyLinkedList(legal_vals); /*free the now unused legal values list*/
+					appendToLinkedList(&digits,lowest_digit(legal));
 				}
 			}
 		}
@@ -1484,7 +1885,7 @@ BOOL autofill(sudoku_board *board, STATUS s)
 	{
 		append_ijval_to_recent_move(posi->data, posj->data, 0, posdig->data); /*saves a change to the board*/
 
-		board->cells[posi->data-1][posj->data-1] = posdig->data; /*places the only possible value of the cell on that cell*/
+		write_cell(board, posi->data, posj->data, posdig->data); /*places the only possible value of the cell on that cell*/
 		board->filled_cells++;
 
 		/*"i++ except it's three lists*/
@@ -1529,6 +1930,7 @@ static void empty_cells(sudoku_board *board)
 			cells[i][j]=0;
 		}
 	}
+	update_pencil_marks(board);
 }
 
 void reset(sudoku_board *board, STATUS s)
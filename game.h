@@ -32,15 +32,16 @@ int get(sudoku_board *board, int i, int j);
 BOOL set(sudoku_board *board, int i, int j, int value, STATUS status);
 
 /*
- * Validates that the current state of the board is solvable using ILP.
+ * Validates that the current state of the board is solvable using solve_board.
  * Returns and prints if validation passed(TRUE) or failed(FALSE).
  * If validation passed, updates the stored solution of board.
+ * Returns CANCELLED and prints it if validation ran out of its time budget.
  * Assumes the mode is Edit or Solve and that the board is not erroneous.
  */
 BOOL validate(sudoku_board *board);
 
 /*
- * Runs ILP to solve the board. If the board is unsolvable prints an error message.
+ * Runs solve_board to solve the board. If the board is unsolvable prints an error message.
  * Else, prints to the user the value at column x and row y of the solution.
  * Assumes the mode is Solve, the board is not erroneous,
  * cell <x,y> is not fixed and doesn't contain a value.
@@ -58,6 +59,7 @@ int fixed_or_error(sudoku_board *board, int i,int j);
  * Return True iff "value" is a legal value for column i row j of board (meaning it is different from all neighbors).
  * If sol is TRUE:
  * Return True iff "value" is a legal value for column i row j of board.solution (meaning it is different from all neighbors).
+ * The cells of a played board are looked up in its pencil marks (see pencil.h).
  */
 BOOL is_legal(sudoku_board *board, int i, int j, int value, BOOL sol);
 
@@ -68,9 +70,17 @@ void print_board(sudoku_board *board,STATUS status);
 
 /*
  * Returns a LINKEDLIST of legal values for the cell at row i-1 and column j-1.
+ * The cells of a played board are looked up in its pencil marks (see pencil.h).
  */
 LINKEDLIST get_legal_values(sudoku_board *board, int i, int j,BOOL sol);
 
+/*
+ * Prints the legal values of column x and row y of the board, the digits that no other cell of one of its groups holds,
+ * from the pencil marks of the board. The cell may be filled.
+ * Assumes the mode is Edit or Solve.
+ */
+void show_candidates(sudoku_board *board, int x, int y);
+
 /*
  * returns the value of the i,j cell in solution.
  * 1<=i,j<=length and board is initialized are assumed.
@@ -102,6 +112,28 @@ void edit_no_param(sudoku_board *board);
  */
 void set_mark_errors(int x);
 
+/*
+ * Sets the global parameter "monitor_solvability" to x: when it is 1, the prompt of Solve mode tells whether
+ * the board can still be solved (see get_solvability_flag).
+ * Assumes x is 1 or 0.
+ */
+void set_monitor(int x);
+
+/*
+ * Returns the flag the prompt shows for board: " (solvable)", " (unsolvable)", or " (undecided)" when the check
+ * gave up, from check_solvability (see monitor.h). Returns "" if the monitor is off or the mode isn't Solve.
+ * Checks the board every time it is called, so after every set and every other command that changes the board.
+ */
+const char* get_solvability_flag(sudoku_board *board, STATUS s);
+
+/*
+ * Sets the seconds each of validate, hint, fill_forced, guess, guess_hint, generate, num_solutions, estimate,
+ * count_symmetric and enumerate may run.
+ * A command that runs out of its budget prints that it was stopped and leaves the board and the moves unchanged.
+ * Assumes seconds >= 0, 0 means no limit.
+ */
+void set_time_budget(double seconds);
+
 /*
  * Guesses a solution to the current board using LP with threshold X.
  * Fills all cell values with a score of X or greater. If several values hold for the same cell,
@@ -124,9 +156,10 @@ void guess_hint(sudoku_board *board, int x, int y);
 
 /*
  * Generates a puzzle by randomly filling X empty cells on the current board with legal values,
- * running ILP to solve the board, and then clearing all but (any) Y random cells.
+ * drawing a random solution of the filled board with sample_solution, and then clearing all but (any) Y random cells.
  * Assumes X and Y are legal values and in the correct range, plus the board is not erroneous.
  * The method prints the board if the command was executed successfully.
+ * If the board is unsolvable or the command runs out of its time budget, the board and the moves are left as they were.
  */
 void generate(sudoku_board *board, int X, int Y);
 
@@ -159,8 +192,47 @@ void save(sudoku_board *board, STATUS s, FILE *f);
 /*
  * Runs an exhaustive backtracking algorithm for the current board to find how many solutions
  * there are, and then prints the result.
+ * If limit is not NO_LIMIT, the search stops after limit solutions.
+ * Prints that the command was stopped if it ran out of its time budget.
+ */
+void num_solutions(sudoku_board *board, int limit);
+
+/*
+ * The seconds the estimate command spends on probes when it isn't given any.
+ */
+#define DEFAULT_ESTIMATE_SECONDS (1.0)
+
+/*
+ * Estimates the number of solutions of the current board with random probes of its search tree
+ * for the given seconds (see estimate_solutions), and prints the estimate with its 95% confidence interval.
+ * Prints that the command was stopped if no probe ended in time.
+ * Assumes the mode is Edit or Solve, the board is not erroneous and seconds > 0.
+ */
+void estimate(sudoku_board *board, double seconds);
+
+/*
+ * Counts the solutions of the current board exactly, with no limit on their number, by counting one of every
+ * orbit of symmetric solutions (see symmetry.h), and prints the result and the number of symmetries divided out.
+ * Prints that the command was stopped if it ran out of its time budget.
+ * Assumes the mode is Edit or Solve and the board is not erroneous.
+ */
+void count_symmetric(sudoku_board *board);
+
+/*
+ * Writes every solution of the current board to the file f, opened for binary writing,
+ * in the format of solution_writer.h (delta encoded if delta is TRUE), and prints how many were written.
+ * If the command runs out of its time budget, the solutions found until then are in the file.
+ * Assumes the mode is Edit or Solve and the board is not erroneous.
+ */
+void enumerate(sudoku_board *board, FILE *f, BOOL delta);
+
+/*
+ * Fills every empty cell that has the same value in all the solutions of the board (see find_backbone), as one move.
+ * Assumes the mode is Solve and the board is not erroneous.
+ * The method prints the board if the command was executed successfully.
+ * Returns whether the last cell of the board was filled.
  */
-void num_solutions(sudoku_board *board);
+BOOL fill_forced(sudoku_board *board);
 
 /*
  * Automatically fills cells which contained a single legal value before this command was executed.
@@ -0,0 +1,200 @@
+#include "groups.h"
+
+/*
+ * This module describes the rules of a board as a table of "all-different" groups: sets of length cells
+ * that must hold different digits, so every group holds every digit exactly once.
+ * The rows, the columns and the regions (the blocks, or the pieces of a jigsaw) are groups, and so are the
+ * extra groups of a variant: the two main diagonals (X-sudoku) and the windows between the blocks (windoku).
+ */
+
+void set_block_regions(sudoku_board *board)
+{
+	/*
+	 * Fills board->region with the blocks of the board, so the board has the regions of a regular sudoku.
+	 * Assumes board->region is allocated.
+	 */
+	int hor = board->block_horizontal, ver = board->block_vertical;
+	int i, j;
+	for(i = 0; i < board->length; i++)
+	{
+		for(j = 0; j < board->length; j++)
+		{/*there are ver blocks in every row of blocks*/
+			board->region[i][j] = i/hor + (j/ver)*ver;
+		}
+	}
+}
+
+BOOL are_regions_legal(sudoku_board *board)
+{
+	/*
+	 * Returns TRUE if board->region splits the board into length regions (numbered from 0) of length cells each,
+	 * FALSE otherwise.
+	 */
+	int length = board->length;
+	int i, j, region;
+	BOOL legal = TRUE;
+	int *sizes = (int*)calloc(length,sizeof(int));
+	check_alloc(sizes,"are_regions_legal");
+	for(i = 0; i < length && legal; i++)
+	{
+		for(j = 0; j < length && legal; j++)
+		{
+			region = board->region[i][j];
+			legal = (region >= 0 && region < length && ++sizes[region] <= length);
+		}
+	}
+	free(sizes);
+	return legal;
+}
+
+static int count_windows(int length, int side)
+{
+	/*
+	 * Returns the number of windows of the given side that fit along a line of length cells,
+	 * when they start one cell after the line and keep one cell between them.
+	 */
+	return (length - 1)/(side + 1);
+}
+
+static int count_groups(sudoku_board *board)
+{
+	/*
+	 * Returns the number of groups of board: its rows, columns and regions and the extra groups of its variant.
+	 */
+	int num_groups = 3*board->length;
+	if(board->variant & DIAGONAL_GROUPS)
+	{
+		num_groups += 2;
+	}
+	if(board->variant & WINDOKU_GROUPS)
+	{
+		num_groups += count_windows(board->length,board->block_horizontal)
+				* count_windows(board->length,board->block_vertical);
+	}
+	return num_groups;
+}
+
+BOOL are_blocks(sudoku_board *board)
+{
+	/*
+	 * Returns TRUE if the regions of board are its blocks, FALSE otherwise.
+	 */
+	int hor = board->block_horizontal, ver = board->block_vertical;
+	int i, j;
+	for(i = 0; i < board->length; i++)
+	{
+		for(j = 0; j < board->length; j++)
+		{
+			if(board->region[i][j] != i/hor + (j/ver)*ver)
+			{
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+group_table* new_group_table(sudoku_board *board)
+{
+	/*
+	 * Builds the group table of board from its regions (board->region) and variant (board->variant).
+	 * Assumes the regions are legal.
+	 * Uses malloc, free it with free_group_table.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int length = board->length, num_cells = length*length;
+	int hor = board->block_horizontal, ver = board->block_vertical;
+	int cell, group, k, a, b, region;
+	int *filled; /*the cells put in every group so far, and then the groups put for every cell*/
+	group_table *groups = (group_table*)malloc(sizeof(group_table));
+	check_alloc(groups,"new_group_table");
+
+	groups->length = length;
+	groups->num_groups = count_groups(board);
+	groups->standard = (board->variant == 0 && are_blocks(board));
+	groups->cells = (int*)malloc(groups->num_groups*length*sizeof(int));
+	groups->first_group = (int*)calloc(num_cells+1,sizeof(int));
+	groups->groups_of = (int*)malloc(groups->num_groups*length*sizeof(int));
+	filled = (int*)calloc(groups->num_groups > num_cells ? groups->num_groups : num_cells,sizeof(int));
+	check_alloc(groups->cells,"new_group_table");
+	check_alloc(groups->first_group,"new_group_table");
+	check_alloc(groups->groups_of,"new_group_table");
+	check_alloc(filled,"new_group_table");
+
+	for(cell = 0; cell < num_cells; cell++)
+	{/*row major order, so the cells of every region are in row major order too*/
+		groups->cells[(cell/length)*length + cell%length] = cell;
+		groups->cells[(length + cell%length)*length + cell/length] = cell;
+		region = 2*length + board->region[cell%length][cell/length];
+		groups->cells[region*length + filled[region]++] = cell;
+	}
+	group = 3*length;
+	if(board->variant & DIAGONAL_GROUPS)
+	{
+		for(k = 0; k < length; k++)
+		{
+			groups->cells[group*length + k] = k + k*length;
+			groups->cells[(group+1)*length + k] = (length-1-k) + k*length;
+		}
+		group += 2;
+	}
+	if(board->variant & WINDOKU_GROUPS)
+	{/*the window (a,b) starts at column a*(hor+1)+1 and row b*(ver+1)+1*/
+		for(b = 0; b < count_windows(length,ver); b++)
+		{
+			for(a = 0; a < count_windows(length,hor); a++)
+			{
+				for(k = 0; k < length; k++)
+				{
+					groups->cells[group*length + k] = (a*(hor+1)+1 + k%hor) + (b*(ver+1)+1 + k/hor)*length;
+				}
+				group++;
+			}
+		}
+	}
+
+	/*the groups of every cell, counted first so they can be laid out one cell after the other*/
+	for(k = 0; k < groups->num_groups*length; k++)
+	{
+		groups->first_group[groups->cells[k]+1]++;
+	}
+	for(cell = 0; cell < num_cells; cell++)
+	{
+		groups->first_group[cell+1] += groups->first_group[cell];
+		filled[cell] = 0;
+	}
+	for(group = 0; group < groups->num_groups; group++)
+	{
+		for(k = 0; k < length; k++)
+		{
+			cell = groups->cells[group*length + k];
+			groups->groups_of[groups->first_group[cell] + filled[cell]++] = group;
+		}
+	}
+	free(filled);
+	return groups;
+}
+
+void free_group_table(group_table *groups)
+{
+	/*
+	 * Frees all memory of groups. groups may be NULL.
+	 */
+	if(groups != NULL)
+	{
+		free(groups->cells);
+		free(groups->first_group);
+		free(groups->groups_of);
+		free(groups);
+	}
+}
+
+void update_groups(sudoku_board *board)
+{
+	/*
+	 * Rebuilds board->groups, after board->region or board->variant changed.
+	 * Terminates the program on a memory allocation error.
+	 */
+	free_group_table(board->groups);
+	board->groups = new_group_table(board);
+}
@@ -0,0 +1,65 @@
+#ifndef GROUPS_H_
+#define GROUPS_H_
+
+#include <stdlib.h>
+#include "definitions.h"
+#include "main_aux.h"
+
+/*
+ * This module describes the rules of a board as a table of "all-different" groups: sets of length cells
+ * that must hold different digits, so every group holds every digit exactly once.
+ * The rows, the columns and the regions (the blocks, or the pieces of a jigsaw) are groups, and so are the
+ * extra groups of a variant: the two main diagonals (X-sudoku) and the windows between the blocks (windoku).
+ * The solvers, the ILP model and the error marker only go over the table, so a variant needs no code of its own
+ * beyond the groups it adds here.
+ */
+
+typedef struct group_table_struct
+{
+	int length; /*every group has length cells*/
+	int num_groups; /*groups 0..length-1 are the rows, length..2*length-1 the columns, 2*length..3*length-1
+					 *the regions, and the extra groups of the variant come after them*/
+	int *cells; /*cells[g*length + k] is the k-th cell of group g. cell = (i-1)+(j-1)*length for column i and row j.
+				 *Cell k of a row is in column k and cell k of a column is in row k*/
+	int *first_group; /*the groups of cell are groups_of[first_group[cell]..first_group[cell+1]-1], in increasing order*/
+	int *groups_of;
+	BOOL standard; /*TRUE if the groups are exactly the rows, the columns and the blocks*/
+}group_table;
+
+/*
+ * Fills board->region with the blocks of the board, so the board has the regions of a regular sudoku.
+ * Assumes board->region is allocated.
+ */
+void set_block_regions(sudoku_board *board);
+
+/*
+ * Returns TRUE if board->region splits the board into length regions (numbered from 0) of length cells each,
+ * FALSE otherwise.
+ */
+BOOL are_regions_legal(sudoku_board *board);
+
+/*
+ * Returns TRUE if the regions of board are its blocks, FALSE otherwise.
+ */
+BOOL are_blocks(sudoku_board *board);
+
+/*
+ * Builds the group table of board from its regions (board->region) and variant (board->variant).
+ * Assumes the regions are legal.
+ * Uses malloc, free it with free_group_table.
+ * Terminates the program on a memory allocation error.
+ */
+group_table* new_group_table(sudoku_board *board);
+
+/*
+ * Frees all memory of groups. groups may be NULL.
+ */
+void free_group_table(group_table *groups);
+
+/*
+ * Rebuilds board->groups, after board->region or board->variant changed.
+ * Terminates the program on a memory allocation error.
+ */
+void update_groups(sudoku_board *board);
+
+#endif /* GROUPS_H_ */
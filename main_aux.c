@@ -1,4 +1,9 @@
 #include "main_aux.h"
+#include "groups.h"
+#include "cages.h"
+#include "pencil.h"
+#include "candidates.h"
+#include "solve_cache.h"
 
 void check_alloc(void* thing, char* func_name)
 {
@@ -33,6 +38,12 @@ static BOOL free_board(sudoku_board *board)
 		free_matrix(board->cells,length);
 		free_matrix(board->fixed_or_error,length);
 		free_matrix(board->solution,length);
+		free_matrix(board->region,length);
+		free_group_table(board->groups);
+		free_cage_table(board->cages);
+		free_pencil_marks(board->marks);
+		free_candidates(board->monitor);
+		free_solve_cache(board->cache);
 	}
 	/*frees up the memory allocated for the board itself*/
 	free(board);
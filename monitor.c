@@ -0,0 +1,64 @@
+#include "monitor.h"
+
+/*
+ * This module checks, between the moves of a game, whether the board can still be solved.
+ * The check has to be fast enough to run after every move on the largest boards. Most moves keep the board
+ * on the solution found last, which settles the check with a pass over the board, and else it propagates
+ * the forced cells, which settles most other boards, and only then searches, for at most MONITOR_SECONDS.
+ * It runs on candidates that are made once per board and only reloaded between checks.
+ */
+
+int check_solvability(sudoku_board *board)
+{
+	/*
+	 * Returns TRUE if board can be solved, FALSE if it can't (which includes a board with errors),
+	 * or CANCELLED if the check couldn't tell within MONITOR_SECONDS.
+	 * A solution the check finds is stored in board->solution, where the next checks look first.
+	 * Makes board->monitor on the first check, free it with free_candidates when the groups or the cages of the board change.
+	 * Assumes board is initialized.
+	 * Terminates the program on a memory allocation error.
+	 */
+	candidates *c;
+	cancel_token *token;
+	int result, cell;
+	if(board->num_errors > 0)
+	{
+		return FALSE;
+	}
+	if(solution_fits_board(board))
+	{/*the moves since the last solve kept to its solution*/
+		return TRUE;
+	}
+	result = get_cached_solvability(board);
+	if(result != ERROR)
+	{
+		return result;
+	}
+	if(board->monitor == NULL)
+	{/*making the candidates (their keys most of all) takes longer than many checks*/
+		board->monitor = new_candidates(board);
+	}
+	c = board->monitor;
+	/*loading the cells takes a pass over the board, and saves following every command that changes them*/
+	if(!load_candidates(c,board->cells))
+	{
+		return FALSE;
+	}
+	start_trail(c);
+	if(!propagate(c))
+	{
+		return FALSE;
+	}
+	token = new_cancel_token(NULL);
+	set_deadline(token,MONITOR_SECONDS);
+	result = find_completion(c,token);
+	free_cancel_token(token);
+	if(result == TRUE)
+	{/*c is filled with the solution*/
+		for(cell = 0; cell < c->num_cells; cell++)
+		{
+			board->solution[c->column_of[cell]][c->row_of[cell]] = c->grid[cell];
+		}
+	}
+	return result;
+}
@@ -0,0 +1,36 @@
+#ifndef MONITOR_H_
+#define MONITOR_H_
+
+#include <stdlib.h>
+#include "definitions.h"
+#include "main_aux.h"
+#include "candidates.h"
+#include "solver.h"
+#include "solve_cache.h"
+#include "cancel.h"
+
+/*
+ * This module checks, between the moves of a game, whether the board can still be solved.
+ * The check has to be fast enough to run after every move on the largest boards. Most moves keep the board
+ * on the solution found last, which settles the check with a pass over the board, and else it propagates
+ * the forced cells, which settles most other boards, and only then searches, for at most MONITOR_SECONDS.
+ * It runs on candidates that are made once per board and only reloaded between checks.
+ */
+
+/*
+ * The seconds a check may search for a solution before it gives up and calls the board undecided,
+ * the time a move may take. Enough for most 25x25 puzzles, but not for an almost empty 25x25 board.
+ */
+#define MONITOR_SECONDS (0.001)
+
+/*
+ * Returns TRUE if board can be solved, FALSE if it can't (which includes a board with errors),
+ * or CANCELLED if the check couldn't tell within MONITOR_SECONDS.
+ * A solution the check finds is stored in board->solution, where the next checks look first.
+ * Makes board->monitor on the first check, free it with free_candidates when the groups or the cages of the board change.
+ * Assumes board is initialized.
+ * Terminates the program on a memory allocation error.
+ */
+int check_solvability(sudoku_board *board);
+
+#endif /* MONITOR_H_ */
@@ -1,5 +1,6 @@
 #include "move_list.h"
 #include "game.h"
+#include "pencil.h"
 #include "msg_prints.h"
 
 /*
@@ -131,7 +132,7 @@ void append_new_move(char* command_info)
 	 *we need to allocate memory for it on the heap.
 	 *If we don't do that, the string will be removed or lost inside the stack after the function has returned,
 	 *and we won't be able to access it.*/
-	cmdinfo = (char*)malloc(sizeof(char)*strlen(command_info));
+	cmdinfo = (char*)malloc(sizeof(char)*(strlen(command_info)+1)); /*+1 for the '\0'*/
 	check_alloc(cmdinfo,"append_new_move");
 	strcpy(cmdinfo, command_info);/*from command_info(stack) to cmdinfo(heap)*/
 	new_move->command_info = cmdinfo;
@@ -302,7 +303,7 @@ void restore_prev_values_of_move(sudoku_board *board, doublyLinkedNode *move_nod
 		j = ijvalp->j;
 		pre_val = ijvalp->prev_val;
 		update_filled_cells(board, board->cells[i-1][j-1], pre_val);
-		board->cells[i-1][j-1] = pre_val;
+		write_cell(board, i, j, pre_val);
 		update_err_changed_cell(board, i, j, s);
 		return;
 	 }
@@ -315,7 +316,7 @@ void restore_prev_values_of_move(sudoku_board *board, doublyLinkedNode *move_nod
 			j = ijvalp->j;
 			pre_val=ijvalp->prev_val;
 			update_filled_cells(board, board->cells[i-1][j-1], pre_val);
-			board->cells[i-1][j-1] = pre_val;
+			write_cell(board, i, j, pre_val);
 			end_set_node = end_set_node->prev;
 		}
 		/*finished restoring from all nodes*/
@@ -347,7 +348,7 @@ void restore_next_values_of_move(sudoku_board *board, doublyLinkedNode *move_nod
 		j = ijvalp->j;
 		ne_val = ijvalp->ne_val;
 		update_filled_cells(board, board->cells[i-1][j-1], ne_val);
-		board->cells[i-1][j-1] = ne_val;
+		write_cell(board, i, j, ne_val);
 		update_err_changed_cell(board, i, j, s);
 		return;
 	 }
@@ -360,7 +361,7 @@ void restore_next_values_of_move(sudoku_board *board, doublyLinkedNode *move_nod
 			j = ijvalp->j;
 			ne_val = ijvalp->ne_val;
 			update_filled_cells(board, board->cells[i-1][j-1], ne_val);
-			board->cells[i-1][j-1] = ne_val;
+			write_cell(board, i, j, ne_val);
 			set_node = set_node->prev;
 		}
 		/*finished restoring from all nodes*/
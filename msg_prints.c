@@ -94,6 +94,16 @@ void print_cant_hint()
 	printf("Error: Board is unsolvable, can't hint.\n");
 }
 
+void print_cant_fill_forced()
+{
+	printf("Error: Board is unsolvable, can't fill forced cells.\n");
+}
+
+void print_cant_generate()
+{
+	printf("Error: Board is unsolvable, can't generate.\n");
+}
+
 void print_puzzle_solved_successfuly()
 {
 	printf("Puzzle was solved successfully! :D. Setting game mode to Init.\n");
@@ -144,3 +154,17 @@ void print_reset_done()
 	printf("The board has been successfully reset to it's loading state.\n");
 }
 
+void print_unknown_solver(char *name)
+{
+	printf("Invalid command: There is no solver called %s.\n", name);
+}
+
+void print_fwrite_error()
+{
+	printf("Error: Could not write to the file. %s.\n", strerror(errno));
+}
+
+void print_timed_out()
+{
+	printf("Error: the command ran out of its time budget and was stopped. The board was not changed.\n");
+}
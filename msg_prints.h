@@ -47,6 +47,10 @@ void print_cell_filled();
 
 void print_cant_hint();
 
+void print_cant_fill_forced();
+
+void print_cant_generate();
+
 void print_puzzle_solved_successfuly();
 
 void print_finished_puzzle_has_errors();
@@ -68,4 +72,10 @@ void print_no_change_in_reset();
 
 void print_reset_done();
 
+void print_unknown_solver(char *name);
+
+void print_fwrite_error();
+
+void print_timed_out();
+
 #endif
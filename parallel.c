@@ -0,0 +1,386 @@
+#define _POSIX_C_SOURCE 200112L /*for pthreads and sysconf under -ansi*/
+#include <pthread.h>
+#include <unistd.h>
+#include <limits.h>
+#include "parallel.h"
+#include "solver.h"
+#include "candidates.h"
+#include "main_aux.h"
+
+/*
+ * This module counts the solutions of a board on several threads.
+ * The search tree is split into subtrees at a shallow depth, and the subtrees are shared
+ * by a pool of worker threads that steal work from each other when they run out.
+ */
+
+/*
+ * How many subtrees are made for every worker. More subtrees balance the work better
+ * but repeat more of the shallow search.
+ */
+#define TASKS_PER_WORKER (16)
+
+/*
+ * The number of worker threads. 0 means one per online processor.
+ */
+static int requested_threads = 0;
+
+/*
+ * A subtree of the search: the branching decisions that lead to it from the root.
+ * decisions[2*k] is the cell and decisions[2*k+1] is the digit of the k-th decision.
+ */
+typedef struct count_task_struct
+{
+	int num_decisions;
+	int *decisions;
+}count_task;
+
+/*
+ * The subtrees waiting in a worker's queue. The owner takes subtrees from the tail,
+ * and other workers steal from the head.
+ */
+typedef struct task_deque_struct
+{
+	pthread_mutex_t lock;
+	int *tasks; /*indices into the task array of the pool*/
+	int head, tail; /*tasks[head..tail-1] are waiting*/
+}task_deque;
+
+struct count_pool_struct;
+
+typedef struct count_worker_struct
+{
+	pthread_t thread;
+	BOOL started; /*TRUE if the thread was created*/
+	int id;
+	struct count_pool_struct *pool;
+}count_worker;
+
+typedef struct count_pool_struct
+{
+	sudoku_board *board;
+	count_task *tasks;
+	int num_tasks;
+	int num_workers;
+	task_deque *deques; /*deques[k] belongs to workers[k]*/
+	count_worker *workers;
+	pthread_mutex_t count_lock; /*guards num_solutions and cancelled*/
+	int num_solutions; /*the solutions found so far by all the workers*/
+	int limit; /*the workers stop once num_solutions reaches it, INT_MAX when counting all the solutions*/
+	cancel_token *token; /*the workers stop once it is cancelled*/
+	BOOL cancelled; /*TRUE if a worker stopped because of token, leaving subtrees uncounted*/
+}count_pool;
+
+void set_num_threads(int num_threads)
+{
+	/*
+	 * Sets the number of worker threads parallel_count_solutions uses.
+	 * 0 (the default) means one thread per online processor.
+	 */
+	requested_threads = num_threads;
+}
+
+static int get_num_workers()
+{
+	/*
+	 * Returns the number of worker threads to use.
+	 */
+	long online;
+	if(requested_threads > 0)
+	{
+		return requested_threads;
+	}
+	online = sysconf(_SC_NPROCESSORS_ONLN);
+	return (online > 0) ? (int)online : 1;
+}
+
+static BOOL replay_task(candidates *c, count_task *task)
+{
+	/*
+	 * Brings c to the root of the subtree task, starting from the loaded board.
+	 * Assumes the trail of c was started on the loaded board.
+	 * Returns FALSE if propagation finds a contradiction on the way, TRUE otherwise.
+	 */
+	int k;
+	undo_trail(c,0);
+	if(!propagate(c))
+	{
+		return FALSE;
+	}
+	for(k = 0; k < task->num_decisions; k++)
+	{
+		assign_digit(c,task->decisions[2*k],task->decisions[2*k+1]);
+		if(!propagate(c))
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static count_task* split_search(candidates *c, int target, int *num_tasks, int *num_solutions)
+{
+	/*
+	 * Splits the search tree of the board loaded in c into at least target subtrees when possible,
+	 * by expanding the shallowest level of the tree with the same branching as count_completions.
+	 * Solutions found while splitting are added to *num_solutions, and subtrees with a contradiction are dropped.
+	 * Returns the array of subtrees and stores its size in *num_tasks. Free it with free_tasks.
+	 */
+	count_task *tasks, *next;
+	int n = 1, next_n, capacity, k, cell, digit;
+	MASK legal;
+	BOOL expanded = TRUE;
+
+	tasks = (count_task*)malloc(sizeof(count_task));
+	check_alloc(tasks,"split_search");
+	tasks[0].num_decisions = 0;
+	tasks[0].decisions = NULL;
+
+	while(n > 0 && n < target && expanded)
+	{/*each round goes one level deeper*/
+		expanded = FALSE;
+		capacity = n*c->length;
+		next = (count_task*)malloc(capacity*sizeof(count_task));
+		check_alloc(next,"split_search");
+		next_n = 0;
+		for(k = 0; k < n; k++)
+		{
+			if(replay_task(c,tasks+k))
+			{
+				if(c->num_placed == c->num_empty)
+				{/*the subtree is a single solution*/
+					(*num_solutions)++;
+				}
+				else
+				{
+					cell = c->order[c->num_placed + most_constrained_cell(c,c->order+c->num_placed,c->num_empty-c->num_placed)];
+					legal = get_cell_candidates(c,cell);
+					while(legal != 0)
+					{
+						digit = lowest_digit(legal);
+						legal &= ~DIGIT_BIT(digit);
+						next[next_n].num_decisions = tasks[k].num_decisions + 1;
+						next[next_n].decisions = (int*)malloc(2*next[next_n].num_decisions*sizeof(int));
+						check_alloc(next[next_n].decisions,"split_search");
+						if(tasks[k].num_decisions > 0)
+						{
+							memcpy(next[next_n].decisions,tasks[k].decisions,2*tasks[k].num_decisions*sizeof(int));
+						}
+						next[next_n].decisions[2*tasks[k].num_decisions] = cell;
+						next[next_n].decisions[2*tasks[k].num_decisions+1] = digit;
+						next_n++;
+					}
+					expanded = TRUE;
+				}
+			}
+			free(tasks[k].decisions);
+		}
+		free(tasks);
+		tasks = next;
+		n = next_n;
+	}
+	*num_tasks = n;
+	return tasks;
+}
+
+static void free_tasks(count_task *tasks, int num_tasks)
+{
+	/*
+	 * Frees the array of subtrees made by split_search.
+	 */
+	int k;
+	for(k = 0; k < num_tasks; k++)
+	{
+		free(tasks[k].decisions);
+	}
+	free(tasks);
+}
+
+static int take_task(count_pool *pool, int id)
+{
+	/*
+	 * Returns the index of the next subtree for worker id: from the tail of its own deque,
+	 * or stolen from the head of another worker's deque if its own is empty.
+	 * Returns -1 if there are no subtrees left anywhere.
+	 */
+	int k, victim, task = -1;
+	task_deque *deque = pool->deques + id;
+
+	pthread_mutex_lock(&deque->lock);
+	if(deque->tail > deque->head)
+	{
+		deque->tail--;
+		task = deque->tasks[deque->tail];
+	}
+	pthread_mutex_unlock(&deque->lock);
+
+	for(k = 1; task == -1 && k < pool->num_workers; k++)
+	{
+		victim = (id + k) % pool->num_workers;
+		deque = pool->deques + victim;
+		pthread_mutex_lock(&deque->lock);
+		if(deque->tail > deque->head)
+		{
+			task = deque->tasks[deque->head];
+			deque->head++;
+		}
+		pthread_mutex_unlock(&deque->lock);
+	}
+	return task;
+}
+
+static int get_task_limit(count_pool *pool)
+{
+	/*
+	 * Returns the limit for counting the next subtree: the solutions still missing to reach the pool's limit,
+	 * or -1 if the limit was already reached or the pool was cancelled.
+	 */
+	int task_limit;
+	pthread_mutex_lock(&pool->count_lock);
+	if(pool->cancelled)
+	{
+		task_limit = -1;
+	}
+	else
+	{
+		task_limit = (pool->num_solutions < pool->limit) ? pool->limit - pool->num_solutions : -1;
+	}
+	pthread_mutex_unlock(&pool->count_lock);
+	return task_limit;
+}
+
+static void* run_worker(void *arg)
+{
+	/*
+	 * The body of a worker thread: counts subtrees on a private candidates structure, with its own share of
+	 * the transposition table memory, until none are left,
+	 * until the pool's limit is reached or until the pool's token is cancelled.
+	 * The counts are added to the pool's num_solutions.
+	 */
+	count_worker *worker = (count_worker*)arg;
+	count_pool *pool = worker->pool;
+	candidates *c = new_candidates(pool->board);
+	int task, task_limit, num_solutions;
+
+	c->memo = new_count_table(pool->num_workers); /*kept across the worker's subtrees, which share a lot*/
+	load_candidates(c,pool->board->cells); /*the board was checked before the workers were started*/
+	start_trail(c);
+	while((task_limit = get_task_limit(pool)) != -1 && (task = take_task(pool,worker->id)) != -1)
+	{
+		if(is_cancelled(pool->token))
+		{/*small subtrees end before count_completions checks the token*/
+			num_solutions = CANCELLED;
+		}
+		else
+		{
+			num_solutions = replay_task(c,pool->tasks+task) ? count_completions(c,task_limit,pool->token) : 0;
+		}
+		pthread_mutex_lock(&pool->count_lock);
+		if(num_solutions == CANCELLED)
+		{
+			pool->cancelled = TRUE;
+		}
+		else
+		{
+			/*tasks counted at the same time may pass the limit together, the sum stops at it*/
+			pool->num_solutions += (num_solutions < pool->limit - pool->num_solutions) ? num_solutions : pool->limit - pool->num_solutions;
+		}
+		pthread_mutex_unlock(&pool->count_lock);
+	}
+	free_candidates(c);
+	return NULL;
+}
+
+int parallel_count_solutions(sudoku_board *board, int limit, cancel_token *token)
+{
+	/*
+	 * Given an initialized sudoku board, counts and returns the amount of possible solutions for the board
+	 * using exhaustive backtracking on several threads. The result is the same as exhaustive_backtracking's.
+	 * If limit is not NO_LIMIT, the workers stop once limit solutions were found together.
+	 * Returns CANCELLED if token (may be NULL) was cancelled or ran out of time before every subtree was counted.
+	 * board->solution is not changed.
+	 * Terminates the program on a memory allocation error.
+	 */
+	count_pool pool;
+	int num_solutions = 0;
+	int k, num_workers = get_num_workers();
+	candidates *c;
+
+	if(num_workers <= 1)
+	{
+		return exhaustive_backtracking(board,limit,token);
+	}
+
+	c = new_candidates(board);
+	if(!load_candidates(c,board->cells))
+	{/*two neighbors with the same value, nothing to count*/
+		free_candidates(c);
+		return 0;
+	}
+	start_trail(c);
+	pool.tasks = split_search(c,TASKS_PER_WORKER*num_workers,&pool.num_tasks,&num_solutions);
+	free_candidates(c);
+
+	pool.board = board;
+	pool.num_solutions = num_solutions;
+	pool.limit = (limit == NO_LIMIT) ? INT_MAX : limit; /*so the sum never overflows*/
+	pool.token = token;
+	pool.cancelled = FALSE;
+	pthread_mutex_init(&pool.count_lock,NULL);
+	pool.num_workers = num_workers;
+	pool.deques = (task_deque*)malloc(num_workers*sizeof(task_deque));
+	pool.workers = (count_worker*)malloc(num_workers*sizeof(count_worker));
+	check_alloc(pool.deques,"parallel_count_solutions");
+	check_alloc(pool.workers,"parallel_count_solutions");
+
+	/*deal the subtrees round robin*/
+	for(k = 0; k < num_workers; k++)
+	{
+		pthread_mutex_init(&pool.deques[k].lock,NULL);
+		pool.deques[k].tasks = (int*)malloc((pool.num_tasks/num_workers+1)*sizeof(int));
+		check_alloc(pool.deques[k].tasks,"parallel_count_solutions");
+		pool.deques[k].head = 0;
+		pool.deques[k].tail = 0;
+	}
+	for(k = 0; k < pool.num_tasks; k++)
+	{
+		pool.deques[k%num_workers].tasks[pool.deques[k%num_workers].tail++] = k;
+	}
+
+	for(k = 0; k < num_workers; k++)
+	{
+		pool.workers[k].id = k;
+		pool.workers[k].pool = &pool;
+		pool.workers[k].started = (pthread_create(&pool.workers[k].thread,NULL,run_worker,pool.workers+k) == 0);
+	}
+	for(k = 0; k < num_workers; k++)
+	{
+		if(pool.workers[k].started)
+		{
+			pthread_join(pool.workers[k].thread,NULL);
+		}
+		else
+		{/*the thread couldn't be created, the calling thread does its share*/
+			run_worker(pool.workers+k);
+		}
+	}
+	num_solutions = pool.num_solutions;
+	if(pool.cancelled)
+	{
+		num_solutions = CANCELLED;
+	}
+	else if(limit != NO_LIMIT && num_solutions > limit)
+	{/*splitting the search may find a few solutions more than the limit*/
+		num_solutions = limit;
+	}
+
+	for(k = 0; k < num_workers; k++)
+	{
+		pthread_mutex_destroy(&pool.deques[k].lock);
+		free(pool.deques[k].tasks);
+	}
+	pthread_mutex_destroy(&pool.count_lock);
+	free(pool.deques);
+	free(pool.workers);
+	free_tasks(pool.tasks,pool.num_tasks);
+	return num_solutions;
+}
@@ -0,0 +1,29 @@
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include "definitions.h"
+#include "cancel.h"
+
+/*
+ * This module counts the solutions of a board on several threads.
+ * The search tree is split into subtrees at a shallow depth, and the subtrees are shared
+ * by a pool of worker threads that steal work from each other when they run out.
+ */
+
+/*
+ * Sets the number of worker threads parallel_count_solutions uses.
+ * 0 (the default) means one thread per online processor.
+ */
+void set_num_threads(int num_threads);
+
+/*
+ * Given an initialized sudoku board, counts and returns the amount of possible solutions for the board
+ * using exhaustive backtracking on several threads. The result is the same as exhaustive_backtracking's.
+ * If limit is not NO_LIMIT, the workers stop once limit solutions were found together.
+ * Returns CANCELLED if token (may be NULL) was cancelled or ran out of time before every subtree was counted.
+ * board->solution is not changed.
+ * Terminates the program on a memory allocation error.
+ */
+int parallel_count_solutions(sudoku_board *board, int limit, cancel_token *token);
+
+#endif /* PARALLEL_H_ */
@@ -273,6 +273,46 @@ static void continue_checking_mark_errors(char *delimiters, STATUS s, sudoku_boa
 	print_board(board,s);
 }
 
+static void continue_checking_monitor(char *delimiters, STATUS s)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * If the command is invalid, prints a detailed error message.
+	 * Else, executes the set_monitor command.
+	 */
+	char *token, *p;/*input for monitor as a char and p for extra invalid parameters*/
+	float x; /*input for monitor as a float*/
+	BOOL res;
+
+	if(s!=SOLVE)
+	{
+		print_invalid_mode("Solve mode");
+		return;
+	}
+	token = strtok(NULL, delimiters);
+	if(token==NULL)
+	{
+		print_not_enough_parameters(1, "");
+		return;
+	}
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{
+		print_too_many_parameters(1, "");
+		return;
+	}
+
+	res = strToNum(token, &x);
+	if(res==FALSE){print_nan("");return;}
+	if(isWhole(x)==FALSE){print_ni(""); return;}
+	if(x!=0 && x!=1)
+	{
+		print_parameter_notInRange("", "0 or 1");
+		return;
+	}
+	set_monitor(x);
+}
+
 static void continue_checking_print_board(char *delimiters, STATUS s, sudoku_board *board)
 {
 	/*
@@ -631,8 +671,8 @@ static void continue_checking_save(char *delimiters, STATUS s,sudoku_board *boar
 		/*checking if the board has a solution*/
 		printf("Validating board before saving...\n");
 		vald_result = validate(board);
-		if(vald_result==ERROR)
-		{
+		if(vald_result==ERROR || vald_result==CANCELLED)
+		{/*validate printed the error*/
 			return;
 		}
 		if(vald_result==FALSE)
@@ -707,6 +747,39 @@ static void continue_checking_hint(char *delimiters,STATUS s,sudoku_board *board
 	}
 }
 
+static void continue_checking_candidates(char *delimiters,STATUS s,sudoku_board *board)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * Checks if all the parameters are given and in range, then executes show_candidates.
+	 * Else, prints a detailed error message.
+	 */
+	float X,Y; /*X Y inputs.*/
+	char *x ,*y, *p; /*tmp inputs, to check if they are not NULL. p for additional invalid input*/
+
+	if(s==INIT)
+	{
+		print_invalid_mode("Edit and Solve modes");
+		return;
+	}
+	/*get parameters from input*/
+	x = strtok(NULL,delimiters);
+	y = strtok(NULL,delimiters);
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{/*at least one parameters to many*/
+		print_too_many_parameters(2, "s");
+		return;
+	}
+	if(x==NULL || y==NULL)
+	{/*a valid command but not all parameters were given*/
+		print_not_enough_parameters(2, "s");
+		return;
+	}
+	if(check_cell_c(x,&X,y,&Y,board->length)==FALSE){return;}
+	show_candidates(board, X, Y);
+}
+
 static void continue_checking_guess_hint(char *delimiters,STATUS s,sudoku_board *board)
 {
 	/*
@@ -767,11 +840,16 @@ static void continue_checking_num_solutions(char *delimiters, STATUS s, sudoku_b
 	 * Helper function for get_and_execute_command.
 	 * Executes num_solutions if:
 	 * 		the current mode is Edit or Solve
-	 * 		there are no extra parameters
+	 * 		there is at most one parameter, and if given it is a positive integer
 	 * 		the board is not erroneous
 	 * Else, prints an error message.
+	 * The optional parameter X stops the count after X solutions.
 	 */
+	char *x;/*the optional limit*/
 	char *p;/*additional invalid input*/
+	float X; /*the limit as a float*/
+	int limit = NO_LIMIT;
+	BOOL res;
 
 	if(s!=EDIT && s!=SOLVE)
 	{
@@ -779,21 +857,331 @@ static void continue_checking_num_solutions(char *delimiters, STATUS s, sudoku_b
 		return;
 	}
 	/*get parameters from input*/
+	x = strtok(NULL,delimiters);
 	p = strtok(NULL,delimiters);
 	if(p!=NULL)
 	{/*at least one parameters to many*/
-		print_too_many_parameters(0, "s");
+		print_too_many_parameters(1, "");
 		return;
 	}
+	if(x!=NULL)
+	{
+		res = strToNum(x, &X);
+		if(res==FALSE){print_nan("");return;}
+		if(isWhole(X)==FALSE){print_ni(""); return;}
+		if(X<1 || X>INT_MAX)
+		{
+			print_parameter_notInRange("", "a positive integer");
+			return;
+		}
+		limit = (int)X;
+	}
 	if(board->num_errors>0)
 	{
 		print_erroneous_board("");
 		return;
 	}
-	num_solutions(board);
+	num_solutions(board, limit);
 	return;
 }
 
+static void continue_checking_estimate(char *delimiters, STATUS s, sudoku_board *board)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * Executes estimate if:
+	 * 		the current mode is Edit or Solve
+	 * 		there is at most one parameter, and if given it is a positive number of seconds
+	 * 		the board is not erroneous
+	 * Else, prints an error message.
+	 * The optional parameter X is the seconds spent estimating, DEFAULT_ESTIMATE_SECONDS if not given.
+	 */
+	char *x;/*the optional seconds*/
+	char *p;/*additional invalid input*/
+	float X = DEFAULT_ESTIMATE_SECONDS; /*the seconds as a float*/
+	BOOL res;
+
+	if(s!=EDIT && s!=SOLVE)
+	{
+		print_invalid_mode("Edit and Solve modes");
+		return;
+	}
+	/*get parameters from input*/
+	x = strtok(NULL,delimiters);
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{/*at least one parameters to many*/
+		print_too_many_parameters(1, "");
+		return;
+	}
+	if(x!=NULL)
+	{
+		res = strToNum(x, &X);
+		if(res==FALSE){print_nan("");return;}
+		if(X<=0)
+		{
+			print_parameter_notInRange("", "a positive number of seconds");
+			return;
+		}
+	}
+	if(board->num_errors>0)
+	{
+		print_erroneous_board("");
+		return;
+	}
+	estimate(board, X);
+}
+
+static void continue_checking_enumerate(char *delimiters, STATUS s, sudoku_board *board)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * Executes enumerate if:
+	 * 		the current mode is Edit or Solve
+	 * 		there is a path X and at most one more parameter Y, which is 0 or 1 (1 for delta encoding, 0 by default)
+	 * 		the board is not erroneous
+	 * 		the file at path X can be opened for writing
+	 * Else, prints an error message.
+	 */
+	char *path;/*the file the solutions are written to*/
+	char *y;/*the optional delta flag*/
+	char *p;/*additional invalid input*/
+	float Y; /*the delta flag as a float*/
+	BOOL delta = FALSE;
+	BOOL res;
+	FILE *f;
+
+	if(s!=EDIT && s!=SOLVE)
+	{
+		print_invalid_mode("Edit and Solve modes");
+		return;
+	}
+	path = strtok(NULL,delimiters);
+	if(path==NULL)
+	{
+		print_not_enough_parameters(1, "");
+		return;
+	}
+	y = strtok(NULL,delimiters);
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{/*at least one parameters to many*/
+		print_too_many_parameters(2, "s");
+		return;
+	}
+	if(y!=NULL)
+	{
+		res = strToNum(y, &Y);
+		if(res==FALSE){print_nan("second ");return;}
+		if(Y!=0 && Y!=1)
+		{
+			print_parameter_notInRange("second ", "0 or 1");
+			return;
+		}
+		delta = (Y==1);
+	}
+	if(board->num_errors>0)
+	{
+		print_erroneous_board("");
+		return;
+	}
+	f = fopen(path, "wb");
+	if(f==NULL)
+	{
+		print_fopen_error();
+		return;
+	}
+	enumerate(board, f, delta);
+	fclose(f);
+}
+
+static void continue_checking_time_budget(char *delimiters)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * Executes the time_budget command, which is available in every mode, if:
+	 * 		there is exactly one parameter X, and it is a non-negative number of seconds (0 removes the budget)
+	 * Else, prints an error message.
+	 */
+	char *x;/*the budget in seconds*/
+	char *p;/*additional invalid input*/
+	float X; /*the budget as a float*/
+	BOOL res;
+
+	x = strtok(NULL,delimiters);
+	if(x==NULL)
+	{
+		print_not_enough_parameters(1, "");
+		return;
+	}
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{/*at least one parameters to many*/
+		print_too_many_parameters(1, "");
+		return;
+	}
+	res = strToNum(x, &X);
+	if(res==FALSE){print_nan("");return;}
+	if(X<0)
+	{
+		print_parameter_notInRange("", "a non-negative number of seconds");
+		return;
+	}
+	set_time_budget(X);
+	if(X==0)
+	{
+		printf("Time budget removed.\n");
+	}
+	else
+	{
+		printf("Time budget set to %g seconds.\n",X);
+	}
+}
+
+static void continue_checking_memo_size(char *delimiters)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * Executes the memo_size command, which is available in every mode, if:
+	 * 		there is exactly one parameter X, and it is an integer number of megabytes between 0 and MAX_MEMO_MEGABYTES
+	 * 		(0 turns the memoization of solution counts off)
+	 * Else, prints an error message.
+	 */
+	char *x;/*the cap in megabytes*/
+	char *p;/*additional invalid input*/
+	float X; /*the cap as a float*/
+	BOOL res;
+
+	x = strtok(NULL,delimiters);
+	if(x==NULL)
+	{
+		print_not_enough_parameters(1, "");
+		return;
+	}
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{/*at least one parameters to many*/
+		print_too_many_parameters(1, "");
+		return;
+	}
+	res = strToNum(x, &X);
+	if(res==FALSE){print_nan("");return;}
+	if(isWhole(X)==FALSE){print_ni(""); return;}
+	if(X<0 || X>MAX_MEMO_MEGABYTES)
+	{
+		print_parameter_notInRange("", "an integer between 0 and 65536");
+		return;
+	}
+	set_memo_size((int)X);
+	if(X==0)
+	{
+		printf("Memoization of solution counts turned off.\n");
+	}
+	else
+	{
+		printf("Memoization of solution counts may use %d megabytes.\n",(int)X);
+	}
+}
+
+static void continue_checking_solver(char *delimiters)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * Executes the solver command if there is at most one parameter, which is available in every mode:
+	 * 		without a parameter, prints the solver backends and which one is active
+	 * 		with a parameter X, makes the backend called X the active one
+	 * Else, prints an error message.
+	 */
+	char *x;/*the name of the backend*/
+	char *p;/*additional invalid input*/
+
+	x = strtok(NULL,delimiters);
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{/*at least one parameters to many*/
+		print_too_many_parameters(1, "");
+		return;
+	}
+	if(x==NULL)
+	{
+		print_solver_backends();
+		return;
+	}
+	if(set_solver_backend(x)==FALSE)
+	{
+		print_unknown_solver(x);
+		print_solver_backends();
+		return;
+	}
+	printf("Solver set to %s.\n",x);
+}
+
+static void continue_checking_count_symmetric(char *delimiters, STATUS s, sudoku_board *board)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * Executes count_symmetric if:
+	 * 		the current mode is Edit or Solve
+	 * 		there are no extra parameters
+	 * 		the board is not erroneous
+	 * Else, prints an error message.
+	 */
+	char *p;/*extra parameters which make the command invalid*/
+	if(s!=EDIT && s!=SOLVE)
+	{
+		print_invalid_mode("Edit and Solve modes");
+		return;
+	}
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{
+		print_too_many_parameters(0,"s");
+		return;
+	}
+	if(board->num_errors>0)
+	{
+		print_erroneous_board("");
+		return;
+	}
+	count_symmetric(board);
+}
+
+static BOOL continue_checking_fill_forced(char *delimiters, STATUS s, sudoku_board *board)
+{
+	/*
+	 * Helper function for get_and_execute_command.
+	 * Executes fill_forced if:
+	 * 		the current mode is Solve
+	 * 		there are no extra parameters
+	 * 		the board is not erroneous
+	 * Else, prints an error message.
+	 * Returns TRUE if the board is completely solved in Solve mode, FALSE if not.
+	 */
+	char *p;/*extra parameters which make the command invalid*/
+	if(s!=SOLVE)
+	{
+		print_invalid_mode("Solve mode");
+		return FALSE;
+	}
+	p = strtok(NULL,delimiters);
+	if(p!=NULL)
+	{
+		print_too_many_parameters(0,"s");
+		return FALSE;
+	}
+	if(board->num_errors>0)
+	{
+		print_erroneous_board("");
+		return FALSE;
+	}
+	if(fill_forced(board))
+	{/*the forced values agree with every solution, so the filled board is a solution*/
+		print_puzzle_solved_successfuly_by_computer();
+		return TRUE;
+	}
+	return FALSE;
+}
+
 static BOOL continue_checking_autofill(char *delimiters, STATUS s, sudoku_board *board)
 {
 	/*
@@ -872,6 +1260,7 @@ STATUS get_and_execute_command(sudoku_board *board,STATUS s)
 	 * 		The commands are: solve X
 	 * 						  edit [X] (X is optional)
 	 * 						  mark_errors X
+	 * 						  monitor X
 	 * 						  print_board
 	 * 						  set X Y Z
 	 * 						  validate
@@ -882,7 +1271,15 @@ STATUS get_and_execute_command(sudoku_board *board,STATUS s)
 	 * 						  save X
 	 * 						  hint X Y
 	 * 						  guess_hint X Y
-	 * 						  num_solutions
+	 * 						  candidates X Y
+	 * 						  num_solutions [X] (X is optional)
+	 * 						  estimate [X] (X is optional)
+	 * 						  count_symmetric
+	 * 						  enumerate X [Y] (Y is optional)
+	 * 						  solver [X] (X is optional)
+	 * 						  time_budget X
+	 * 						  memo_size X
+	 * 						  fill_forced
 	 * 						  autofill
 	 * 						  reset
 	 * 						  exit
@@ -905,7 +1302,7 @@ STATUS get_and_execute_command(sudoku_board *board,STATUS s)
 	BOOL switch_to_init; /*TRUE iff the sudoku puzzle is solved completely in solve mode*/
 	BOOL execution_result;/*TRUE iff the command was executed successfully, ERROR otherwise*/
 
-	printf("Enter a command:\n");
+	printf("Enter a command%s:\n", get_solvability_flag(board,s));
 	if((in_len = getline(&input, &buffsize, stdin))!=-1)/*not EOF or read error*/
 	{
 		if(in_len>=MAX_CHAR_CMD-1) /*in_len doesn't include the null terminator*/
@@ -947,6 +1344,12 @@ STATUS get_and_execute_command(sudoku_board *board,STATUS s)
 				free(input);
 				return(s);
 			}
+			else if(strcmp(token,"monitor")==0)
+			{
+				continue_checking_monitor(delimiters, s);
+				free(input);
+				return(s);
+			}
 			else if(strcmp(token,"print_board")==0)
 			{
 				continue_checking_print_board(delimiters, s, board);
@@ -1015,12 +1418,64 @@ STATUS get_and_execute_command(sudoku_board *board,STATUS s)
 				free(input);
 				return(s);
 			}
+			else if(strcmp(token,"candidates")==0)
+			{
+				continue_checking_candidates(delimiters, s, board);
+				free(input);
+				return(s);
+			}
 			else if(strcmp(token,"num_solutions")==0)
 			{
 				continue_checking_num_solutions(delimiters, s, board);
 				free(input);
 				return(s);
 			}
+			else if(strcmp(token,"estimate")==0)
+			{
+				continue_checking_estimate(delimiters, s, board);
+				free(input);
+				return(s);
+			}
+			else if(strcmp(token,"count_symmetric")==0)
+			{
+				continue_checking_count_symmetric(delimiters, s, board);
+				free(input);
+				return(s);
+			}
+			else if(strcmp(token,"enumerate")==0)
+			{
+				continue_checking_enumerate(delimiters, s, board);
+				free(input);
+				return(s);
+			}
+			else if(strcmp(token,"solver")==0)
+			{
+				continue_checking_solver(delimiters);
+				free(input);
+				return(s);
+			}
+			else if(strcmp(token,"time_budget")==0)
+			{
+				continue_checking_time_budget(delimiters);
+				free(input);
+				return(s);
+			}
+			else if(strcmp(token,"memo_size")==0)
+			{
+				continue_checking_memo_size(delimiters);
+				free(input);
+				return(s);
+			}
+			else if(strcmp(token,"fill_forced")==0)
+			{
+				switch_to_init = continue_checking_fill_forced(delimiters, s, board);
+				free(input);
+				if(switch_to_init)
+				{/*The game is finished in Solve mode, so the game mode is set to INIT*/
+					return(INIT);
+				}
+				return(s);
+			}
 			else if(strcmp(token,"autofill")==0)
 			{
 				switch_to_init = continue_checking_autofill(delimiters, s, board);
@@ -4,9 +4,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "definitions.h"
 #include "msg_prints.h"
 #include "game.h"
+#include "backend.h"
+#include "transposition.h"
 #include "main_aux.h"
 
 
@@ -21,6 +24,7 @@
  * 		The commands are: solve X
  * 						  edit [X] (X is optional)
  * 						  mark_errors X
+ * 						  monitor X
  * 						  print_board
  * 						  set X Y Z
  * 						  validate
@@ -31,7 +35,11 @@
  * 						  save X
  * 						  hint X Y
  * 						  guess_hint X Y
- * 						  num_solutions
+ * 						  num_solutions [X] (X is optional)
+ * 						  enumerate X [Y] (Y is optional)
+ * 						  solver [X] (X is optional)
+ * 						  time_budget X
+ * 						  fill_forced
  * 						  autofill
  * 						  reset
  * 						  exit
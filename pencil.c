@@ -0,0 +1,191 @@
+#include "pencil.h"
+
+/*
+ * This module keeps the pencil marks of the live board: the legal values of every cell, meaning the digits
+ * that no other cell of one of its groups holds. They are kept up to date as the cells change, one cell at a time,
+ * so finding the legal values of a cell is a lookup instead of a scan of its neighbors.
+ * The marks also keep a key of the cells, which changes with every write, so the solution cache (see solve_cache.h)
+ * can tell whether it holds the results of the cells without comparing them.
+ */
+
+static int get_cell_value(sudoku_board *board, int cell)
+{
+	/*
+	 * Returns the value of cell in board->cells, 0 if it is empty.
+	 */
+	return board->cells[cell%board->length][cell/board->length];
+}
+
+static unsigned long get_cell_key(int cell, int value)
+{
+	/*
+	 * Returns the key of value (not 0) in cell: the pair mixed by multiplications and shifts,
+	 * so the keys of nearby pairs look unrelated and their xors rarely cancel out.
+	 */
+	unsigned long key = (unsigned long)cell*MAX_LENGTH + value;
+	key = ((key >> 16) ^ key) * 0x45d9f3bUL;
+	key = ((key >> 16) ^ key) * 0x45d9f3bUL;
+	return (key >> 16) ^ key;
+}
+
+static void refresh_marks(sudoku_board *board, int cell, MASK digits)
+{
+	/*
+	 * Recomputes the marks of the digits digits in cell from the counts of its groups:
+	 * a digit is legal if its groups hold it nowhere but in cell itself.
+	 */
+	pencil_marks *marks = board->marks;
+	group_table *groups = board->groups;
+	int length = board->length;
+	int value = get_cell_value(board,cell);
+	int digit, k, others;
+	while(digits != 0)
+	{
+		digit = lowest_digit(digits);
+		digits &= ~DIGIT_BIT(digit);
+		marks->legal[cell] |= DIGIT_BIT(digit);
+		for(k = groups->first_group[cell]; k < groups->first_group[cell+1]; k++)
+		{
+			others = marks->counts[groups->groups_of[k]*length + digit-1] - (value == digit);
+			if(others > 0)
+			{
+				marks->legal[cell] &= ~DIGIT_BIT(digit);
+				break;
+			}
+		}
+	}
+}
+
+void update_pencil_marks(sudoku_board *board)
+{
+	/*
+	 * Rebuilds board->marks from board->cells, after many cells changed at once or the groups changed.
+	 * Assumes board is initialized.
+	 * Terminates the program on a memory allocation error.
+	 */
+	group_table *groups = board->groups;
+	int length = board->length;
+	int num_cells = length*length;
+	int cell, k, value;
+	MASK all_digits = DIGIT_BIT(length) | (DIGIT_BIT(length) - 1);
+	pencil_marks *marks = board->marks;
+
+	if(marks == NULL || marks->length != length)
+	{
+		free_pencil_marks(marks);
+		marks = (pencil_marks*)malloc(sizeof(pencil_marks));
+		check_alloc(marks,"update_pencil_marks");
+		marks->length = length;
+		marks->legal = (MASK*)malloc(num_cells*sizeof(MASK));
+		check_alloc(marks->legal,"update_pencil_marks");
+		marks->counts = NULL;
+		board->marks = marks;
+	}
+	/*the number of groups depends on the variant*/
+	free(marks->counts);
+	marks->counts = (int*)calloc(groups->num_groups*length,sizeof(int));
+	check_alloc(marks->counts,"update_pencil_marks");
+
+	marks->key = 0;
+	for(cell = 0; cell < num_cells; cell++)
+	{
+		value = get_cell_value(board,cell);
+		if(value != 0)
+		{
+			marks->key ^= get_cell_key(cell,value);
+			for(k = groups->first_group[cell]; k < groups->first_group[cell+1]; k++)
+			{
+				marks->counts[groups->groups_of[k]*length + value-1]++;
+			}
+		}
+	}
+	for(cell = 0; cell < num_cells; cell++)
+	{
+		marks->legal[cell] = 0;
+		refresh_marks(board,cell,all_digits);
+	}
+}
+
+void free_pencil_marks(pencil_marks *marks)
+{
+	/*
+	 * Frees all memory of marks. marks may be NULL.
+	 */
+	if(marks != NULL)
+	{
+		free(marks->counts);
+		free(marks->legal);
+		free(marks);
+	}
+}
+
+void write_cell(sudoku_board *board, int i, int j, int value)
+{
+	/*
+	 * Puts value (0 for empty) in column i, row j of board->cells and updates the pencil marks of the cells
+	 * that share a group with it. If board->marks is NULL, only writes the cell.
+	 * Only the old and the new value can change their marks, and only in the groups of the cell.
+	 */
+	pencil_marks *marks = board->marks;
+	group_table *groups = board->groups;
+	int length = board->length;
+	int cell = (i-1) + (j-1)*length;
+	int old_value = board->cells[i-1][j-1];
+	int k, m, group;
+	MASK changed = 0;
+
+	board->cells[i-1][j-1] = value;
+	if(marks == NULL || old_value == value)
+	{
+		return;
+	}
+	for(k = groups->first_group[cell]; k < groups->first_group[cell+1]; k++)
+	{
+		group = groups->groups_of[k];
+		if(old_value != 0)
+		{
+			marks->counts[group*length + old_value-1]--;
+		}
+		if(value != 0)
+		{
+			marks->counts[group*length + value-1]++;
+		}
+	}
+	if(old_value != 0)
+	{
+		changed |= DIGIT_BIT(old_value);
+		marks->key ^= get_cell_key(cell,old_value);
+	}
+	if(value != 0)
+	{
+		changed |= DIGIT_BIT(value);
+		marks->key ^= get_cell_key(cell,value);
+	}
+	for(k = groups->first_group[cell]; k < groups->first_group[cell+1]; k++)
+	{
+		group = groups->groups_of[k];
+		for(m = 0; m < length; m++)
+		{/*the cell itself is in all its groups, and is refreshed with them*/
+			refresh_marks(board,groups->cells[group*length + m],changed);
+		}
+	}
+}
+
+MASK get_pencil_marks(sudoku_board *board, int i, int j)
+{
+	/*
+	 * Returns the legal values of column i, row j of board: the digits that no other cell of one of its groups holds.
+	 * Assumes board->marks is not NULL.
+	 */
+	return board->marks->legal[(i-1) + (j-1)*board->length];
+}
+
+unsigned long get_board_key(sudoku_board *board)
+{
+	/*
+	 * Returns the key of the cells of board: the xor of a hash of every filled cell and its value.
+	 * Equal cells have equal keys, and different cells almost always have different keys.
+	 * Assumes board->marks is not NULL.
+	 */
+	return board->marks->key;
+}
@@ -0,0 +1,58 @@
+#ifndef PENCIL_H_
+#define PENCIL_H_
+
+#include <stdlib.h>
+#include "definitions.h"
+#include "main_aux.h"
+#include "candidates.h"
+#include "groups.h"
+
+/*
+ * This module keeps the pencil marks of the live board: the legal values of every cell, meaning the digits
+ * that no other cell of one of its groups holds. They are kept up to date as the cells change, one cell at a time,
+ * so finding the legal values of a cell is a lookup instead of a scan of its neighbors.
+ * The cages of a killer sudoku are not part of the marks, like they are not part of the error marking.
+ * The marks also keep a key of the cells, which changes with every write, so the solution cache (see solve_cache.h)
+ * can tell whether it holds the results of the cells without comparing them.
+ */
+
+typedef struct pencil_marks_struct
+{
+	int length;
+	int *counts; /*counts[g*length + digit-1] is the number of cells of group g (see groups.h) that hold digit*/
+	MASK *legal; /*legal[cell] holds the legal values of cell. cell = (i-1)+(j-1)*length for column i and row j*/
+	unsigned long key; /*the xor of the keys of the values of the filled cells, see get_board_key*/
+}pencil_marks;
+
+/*
+ * Rebuilds board->marks from board->cells, after many cells changed at once or the groups changed.
+ * Assumes board is initialized.
+ * Terminates the program on a memory allocation error.
+ */
+void update_pencil_marks(sudoku_board *board);
+
+/*
+ * Frees all memory of marks. marks may be NULL.
+ */
+void free_pencil_marks(pencil_marks *marks);
+
+/*
+ * Puts value (0 for empty) in column i, row j of board->cells and updates the pencil marks of the cells
+ * that share a group with it. If board->marks is NULL, only writes the cell.
+ */
+void write_cell(sudoku_board *board, int i, int j, int value);
+
+/*
+ * Returns the legal values of column i, row j of board: the digits that no other cell of one of its groups holds.
+ * Assumes board->marks is not NULL.
+ */
+MASK get_pencil_marks(sudoku_board *board, int i, int j);
+
+/*
+ * Returns the key of the cells of board: the xor of a hash of every filled cell and its value.
+ * Equal cells have equal keys, and different cells almost always have different keys.
+ * Assumes board->marks is not NULL.
+ */
+unsigned long get_board_key(sudoku_board *board);
+
+#endif /* PENCIL_H_ */
@@ -0,0 +1,152 @@
+#define _POSIX_C_SOURCE 200112L /*for pthreads under -ansi*/
+#include <pthread.h>
+#include "portfolio.h"
+#include "solver.h"
+#include "matrix.h"
+#include "main_aux.h"
+
+/*
+ * This module solves a board with several solvers at once (a portfolio), each on its own thread
+ * and on its own copy of the board. The first solver that decides the board wins and the others are cancelled.
+ */
+
+/*
+ * The solvers of the portfolio. None of them keeps global state, so each only touches its own copy of the board.
+ */
+static BOOL (*racers[])(sudoku_board *board, cancel_token *token) =
+{
+	native_solve_board,
+	sat_solve_board,
+	gurobi_solve_board
+};
+
+#define NUM_RACERS ((int)(sizeof(racers)/sizeof(racers[0])))
+
+typedef struct race_struct
+{
+	pthread_mutex_t lock; /*guards winner*/
+	int winner; /*the first racer that decided the board, -1 until there is one*/
+	cancel_token *token; /*cancelled when there is a winner*/
+}race;
+
+typedef struct racer_run_struct
+{
+	pthread_t thread;
+	BOOL started; /*TRUE if the thread was created*/
+	int id; /*index in racers*/
+	race *race;
+	sudoku_board board; /*the racer's own copy of the board*/
+	BOOL result;
+}racer_run;
+
+static void copy_board(sudoku_board *from, sudoku_board *to)
+{
+	/*
+	 * Makes to a copy of the initialized board from, with its own matrices. Free it with free_board_copy.
+	 * The solvers only read the regions, the groups, the cages and the pencil marks, so the copy shares them with from.
+	 */
+	int length = from->length;
+	*to = *from;
+	to->cells = make_matrix(length);
+	to->solution = make_matrix(length);
+	to->fixed_or_error = make_matrix(length);
+	copy_matrix(from->cells,to->cells,length);
+	copy_matrix(from->fixed_or_error,to->fixed_or_error,length);
+	/*the candidates of the solvability monitor and the solve cache stay with from*/
+	to->monitor = NULL;
+	to->cache = NULL;
+}
+
+static void free_board_copy(sudoku_board *board)
+{
+	/*
+	 * Frees the matrices of a board made by copy_board.
+	 */
+	free_matrix(board->cells,board->length);
+	free_matrix(board->solution,board->length);
+	free_matrix(board->fixed_or_error,board->length);
+}
+
+static void* run_racer(void *arg)
+{
+	/*
+	 * The body of a racer thread: solves the racer's copy of the board,
+	 * and if it is the first to decide the board, cancels the others.
+	 */
+	racer_run *run = (racer_run*)arg;
+	race *r = run->race;
+
+	run->result = racers[run->id](&run->board,r->token);
+	if(run->result == TRUE || run->result == FALSE)
+	{
+		pthread_mutex_lock(&r->lock);
+		if(r->winner == -1)
+		{
+			r->winner = run->id;
+			cancel_operation(r->token);
+		}
+		pthread_mutex_unlock(&r->lock);
+	}
+	return NULL;
+}
+
+BOOL portfolio_solve_board(sudoku_board *board, cancel_token *token)
+{
+	/*
+	 * Solves the board with the native backtracking solver, the SAT solver and Gurobi racing each other,
+	 * and stores the winner's solution in board->solution.
+	 * Returns after every solver has stopped, so no solver state outlives the call.
+	 * assumes board is initialized.
+	 * returns TRUE/FALSE if the board is solvable/unsolvable, like solve_board. Returns ERROR if no solver
+	 * decided the board because of errors, or CANCELLED if token (may be NULL) was cancelled first.
+	 * board->solution is left untouched unless TRUE is returned.
+	 */
+	race r;
+	racer_run runs[NUM_RACERS];
+	BOOL result;
+	int k;
+
+	pthread_mutex_init(&r.lock,NULL);
+	r.winner = -1;
+	r.token = new_cancel_token(token);
+
+	for(k = 0; k < NUM_RACERS; k++)
+	{
+		runs[k].id = k;
+		runs[k].race = &r;
+		copy_board(board,&runs[k].board);
+		runs[k].started = (pthread_create(&runs[k].thread,NULL,run_racer,runs+k) == 0);
+	}
+	for(k = 0; k < NUM_RACERS; k++)
+	{
+		if(runs[k].started)
+		{
+			pthread_join(runs[k].thread,NULL);
+		}
+		else
+		{/*the thread couldn't be created, the calling thread runs the racer, which stops soon if the race is over*/
+			run_racer(runs+k);
+		}
+	}
+
+	if(r.winner != -1)
+	{
+		result = runs[r.winner].result;
+		if(result == TRUE)
+		{
+			copy_matrix(runs[r.winner].board.solution,board->solution,board->length);
+		}
+	}
+	else
+	{
+		result = is_cancelled(token) ? CANCELLED : ERROR;
+	}
+
+	for(k = 0; k < NUM_RACERS; k++)
+	{
+		free_board_copy(&runs[k].board);
+	}
+	free_cancel_token(r.token);
+	pthread_mutex_destroy(&r.lock);
+	return result;
+}
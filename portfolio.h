@@ -0,0 +1,23 @@
+#ifndef PORTFOLIO_H_
+#define PORTFOLIO_H_
+
+#include "definitions.h"
+#include "cancel.h"
+
+/*
+ * This module solves a board with several solvers at once (a portfolio), each on its own thread
+ * and on its own copy of the board. The first solver that decides the board wins and the others are cancelled.
+ */
+
+/*
+ * Solves the board with the native backtracking solver, the SAT solver and Gurobi racing each other,
+ * and stores the winner's solution in board->solution.
+ * Returns after every solver has stopped, so no solver state outlives the call.
+ * assumes board is initialized.
+ * returns TRUE/FALSE if the board is solvable/unsolvable, like solve_board. Returns ERROR if no solver
+ * decided the board because of errors, or CANCELLED if token (may be NULL) was cancelled first.
+ * board->solution is left untouched unless TRUE is returned.
+ */
+BOOL portfolio_solve_board(sudoku_board *board, cancel_token *token);
+
+#endif /* PORTFOLIO_H_ */
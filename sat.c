@@ -0,0 +1,857 @@
+#include <stdlib.h>
+#include "sat.h"
+#include "main_aux.h"
+
+/*
+ * This module is a CDCL SAT solver: it decides whether a formula in conjunctive normal form is satisfiable.
+ * It uses two watched literals per clause for propagation, learns a clause at the first unique implication point
+ * of every conflict, picks decisions by VSIDS activity with saved phases, and restarts on the Luby sequence.
+ *
+ * Inside the module variables are numbered from 0, and literal 2*v is variable v while 2*v+1 is its negation.
+ */
+
+#define VALUE_UNDEF (-1) /*the value of an unassigned variable or literal*/
+#define LIT_UNDEF (-1)
+#define NO_REASON (-1) /*the reason of a decision or of a fact from a unit clause*/
+
+/*
+ * Every clause is stored in the clause arena as CLAUSE_HEADER ints followed by its literals:
+ * the number of literals, the flags, and the index of its activity (learnt clauses only).
+ * A clause is referred to by its offset in the arena.
+ * The first two literals of a clause are the watched ones, and the first literal of a reason is the implied one.
+ */
+#define CLAUSE_HEADER (3)
+#define CLAUSE_SIZE(s,ref) ((s)->arena.data[(ref)])
+#define CLAUSE_FLAGS(s,ref) ((s)->arena.data[(ref)+1])
+#define CLAUSE_ACTIVITY(s,ref) ((s)->arena.data[(ref)+2])
+#define CLAUSE_LITS(s,ref) ((s)->arena.data + (ref) + CLAUSE_HEADER)
+#define LEARNT_FLAG (1)
+#define DELETED_FLAG (2)
+
+#define RESTART_BASE (100) /*conflicts in the first restart interval, scaled by the Luby sequence*/
+#define VAR_DECAY (0.95)
+#define CLAUSE_DECAY (0.999)
+#define RESCALE_LIMIT (1e100) /*activities are scaled down when one of them gets bigger than this*/
+#define MIN_LEARNTS (2000) /*the learnt clauses kept before the first database reduction*/
+
+/*
+ * A growable array of ints.
+ */
+typedef struct int_vector_struct
+{
+	int *data;
+	int size;
+	int capacity;
+}int_vector;
+
+struct sat_solver_struct
+{
+	int num_vars;
+	BOOL unsat; /*TRUE once the formula is known to be unsatisfiable*/
+	int_vector arena; /*all the clauses, see CLAUSE_HEADER*/
+	int_vector *watches; /*watches[lit] holds the clauses that watch lit*/
+	int_vector learnts; /*the learnt clauses in the arena that weren't deleted*/
+	double *learnt_activity; /*learnt_activity[CLAUSE_ACTIVITY(ref)] is the activity of the learnt clause ref*/
+	int learnt_capacity; /*the size of learnt_activity*/
+	double clause_inc; /*the amount a clause activity is bumped by*/
+	int max_learnts; /*the learnt clauses are reduced when there are more than this*/
+
+	int *assigns; /*assigns[v] is TRUE, FALSE or VALUE_UNDEF*/
+	int *level; /*level[v] is the decision level v was assigned at*/
+	int *reason; /*reason[v] is the clause that implied v, or NO_REASON*/
+	int *polarity; /*polarity[v] is the last value v had, which is tried first when branching on it*/
+	int *trail; /*the assigned literals in the order they were assigned*/
+	int trail_size;
+	int qhead; /*trail[qhead..trail_size-1] weren't propagated yet*/
+	int_vector trail_lim; /*trail_lim.data[d] is the trail size when decision level d+1 started*/
+
+	double *activity; /*the VSIDS activity of every variable*/
+	double var_inc; /*the amount a variable activity is bumped by*/
+	int *heap; /*the unassigned variables (and maybe some assigned ones), as a binary max-heap by activity*/
+	int heap_size;
+	int *heap_index; /*heap_index[v] is the position of v in heap, or -1*/
+
+	BOOL *seen; /*scratch marks for conflict analysis*/
+	int_vector learnt_clause; /*scratch for the clause being learnt*/
+	int_vector to_clear; /*scratch for the variables whose seen mark has to be cleared*/
+	int *model; /*the values of the variables in the last satisfying assignment*/
+};
+
+static void init_vector(int_vector *v)
+{
+	/*
+	 * Makes v an empty vector.
+	 */
+	v->data = NULL;
+	v->size = 0;
+	v->capacity = 0;
+}
+
+static void push_int(int_vector *v, int x)
+{
+	/*
+	 * Appends x to v, growing v when it is full.
+	 * Terminates the program on a memory allocation error.
+	 */
+	if(v->size == v->capacity)
+	{
+		v->capacity = (v->capacity == 0) ? 4 : 2*v->capacity;
+		v->data = (int*)realloc(v->data,v->capacity*sizeof(int));
+		check_alloc(v->data,"push_int");
+	}
+	v->data[v->size++] = x;
+}
+
+static int to_internal_lit(int lit)
+{
+	/*
+	 * Returns the literal of the module for the DIMACS literal lit.
+	 */
+	return (lit > 0) ? 2*(lit-1) : 2*(-lit-1) + 1;
+}
+
+static int lit_value(sat_solver *s, int lit)
+{
+	/*
+	 * Returns TRUE if lit is true, FALSE if it is false and VALUE_UNDEF if its variable is unassigned.
+	 */
+	int value = s->assigns[lit >> 1];
+	if(value == VALUE_UNDEF)
+	{
+		return VALUE_UNDEF;
+	}
+	return value ^ (lit & 1);
+}
+
+static int decision_level(sat_solver *s)
+{
+	return s->trail_lim.size;
+}
+
+/*
+ * The heap of variables ordered by activity, the root has the highest activity.
+ */
+
+static void heap_up(sat_solver *s, int pos)
+{
+	int var = s->heap[pos];
+	int parent;
+	while(pos > 0)
+	{
+		parent = (pos - 1) >> 1;
+		if(s->activity[s->heap[parent]] >= s->activity[var])
+		{
+			break;
+		}
+		s->heap[pos] = s->heap[parent];
+		s->heap_index[s->heap[pos]] = pos;
+		pos = parent;
+	}
+	s->heap[pos] = var;
+	s->heap_index[var] = pos;
+}
+
+static void heap_down(sat_solver *s, int pos)
+{
+	int var = s->heap[pos];
+	int child;
+	while(2*pos + 1 < s->heap_size)
+	{
+		child = 2*pos + 1;
+		if(child + 1 < s->heap_size && s->activity[s->heap[child+1]] > s->activity[s->heap[child]])
+		{
+			child++;
+		}
+		if(s->activity[s->heap[child]] <= s->activity[var])
+		{
+			break;
+		}
+		s->heap[pos] = s->heap[child];
+		s->heap_index[s->heap[pos]] = pos;
+		pos = child;
+	}
+	s->heap[pos] = var;
+	s->heap_index[var] = pos;
+}
+
+static void heap_insert(sat_solver *s, int var)
+{
+	if(s->heap_index[var] == -1)
+	{
+		s->heap[s->heap_size] = var;
+		s->heap_size++;
+		heap_up(s,s->heap_size - 1);
+	}
+}
+
+static int heap_remove_max(sat_solver *s)
+{
+	/*
+	 * Removes and returns the variable with the highest activity. Assumes the heap is not empty.
+	 */
+	int var = s->heap[0];
+	s->heap_index[var] = -1;
+	s->heap_size--;
+	if(s->heap_size > 0)
+	{
+		s->heap[0] = s->heap[s->heap_size];
+		heap_down(s,0);
+	}
+	return var;
+}
+
+sat_solver* new_sat_solver(int num_vars)
+{
+	/*
+	 * Allocates a solver for a formula over the variables 1...num_vars, with no clauses.
+	 * Uses malloc, free it with free_sat_solver.
+	 * Terminates the program on a memory allocation error.
+	 */
+	int var, lit;
+	sat_solver *s = (sat_solver*)malloc(sizeof(sat_solver));
+	check_alloc(s,"new_sat_solver");
+
+	s->num_vars = num_vars;
+	s->unsat = FALSE;
+	init_vector(&s->arena);
+	init_vector(&s->learnts);
+	init_vector(&s->trail_lim);
+	init_vector(&s->learnt_clause);
+	init_vector(&s->to_clear);
+	s->learnt_activity = NULL;
+	s->learnt_capacity = 0;
+	s->clause_inc = 1;
+	s->max_learnts = MIN_LEARNTS;
+	s->var_inc = 1;
+	s->trail_size = 0;
+	s->qhead = 0;
+	s->heap_size = 0;
+
+	/*+1 so that nothing is allocated with size 0*/
+	s->watches = (int_vector*)malloc((2*num_vars+1)*sizeof(int_vector));
+	s->assigns = (int*)malloc((num_vars+1)*sizeof(int));
+	s->level = (int*)malloc((num_vars+1)*sizeof(int));
+	s->reason = (int*)malloc((num_vars+1)*sizeof(int));
+	s->polarity = (int*)malloc((num_vars+1)*sizeof(int));
+	s->trail = (int*)malloc((num_vars+1)*sizeof(int));
+	s->activity = (double*)malloc((num_vars+1)*sizeof(double));
+	s->heap = (int*)malloc((num_vars+1)*sizeof(int));
+	s->heap_index = (int*)malloc((num_vars+1)*sizeof(int));
+	s->seen = (BOOL*)malloc((num_vars+1)*sizeof(BOOL));
+	s->model = (int*)malloc((num_vars+1)*sizeof(int));
+	check_alloc(s->watches,"new_sat_solver");
+	check_alloc(s->assigns,"new_sat_solver");
+	check_alloc(s->level,"new_sat_solver");
+	check_alloc(s->reason,"new_sat_solver");
+	check_alloc(s->polarity,"new_sat_solver");
+	check_alloc(s->trail,"new_sat_solver");
+	check_alloc(s->activity,"new_sat_solver");
+	check_alloc(s->heap,"new_sat_solver");
+	check_alloc(s->heap_index,"new_sat_solver");
+	check_alloc(s->seen,"new_sat_solver");
+	check_alloc(s->model,"new_sat_solver");
+
+	for(lit = 0; lit < 2*num_vars; lit++)
+	{
+		init_vector(s->watches + lit);
+	}
+	for(var = 0; var < num_vars; var++)
+	{
+		s->assigns[var] = VALUE_UNDEF;
+		s->level[var] = 0;
+		s->reason[var] = NO_REASON;
+		s->polarity[var] = FALSE; /*most variables of a typical encoding are false*/
+		s->activity[var] = 0;
+		s->heap_index[var] = -1;
+		s->seen[var] = FALSE;
+		s->model[var] = FALSE;
+		heap_insert(s,var);
+	}
+	return s;
+}
+
+void free_sat_solver(sat_solver *s)
+{
+	/*
+	 * Frees all memory of s. s may be NULL.
+	 */
+	int lit;
+	if(s == NULL)
+	{
+		return;
+	}
+	for(lit = 0; lit < 2*s->num_vars; lit++)
+	{
+		free(s->watches[lit].data);
+	}
+	free(s->watches);
+	free(s->arena.data);
+	free(s->learnts.data);
+	free(s->trail_lim.data);
+	free(s->learnt_clause.data);
+	free(s->to_clear.data);
+	free(s->learnt_activity);
+	free(s->assigns);
+	free(s->level);
+	free(s->reason);
+	free(s->polarity);
+	free(s->trail);
+	free(s->activity);
+	free(s->heap);
+	free(s->heap_index);
+	free(s->seen);
+	free(s->model);
+	free(s);
+}
+
+static void enqueue(sat_solver *s, int lit, int reason)
+{
+	/*
+	 * Makes the unassigned literal lit true at the current decision level, implied by the clause reason.
+	 */
+	int var = lit >> 1;
+	s->assigns[var] = !(lit & 1);
+	s->level[var] = decision_level(s);
+	s->reason[var] = reason;
+	s->trail[s->trail_size++] = lit;
+}
+
+static void cancel_until(sat_solver *s, int level)
+{
+	/*
+	 * Unassigns every variable that was assigned after decision level level, and saves their phases.
+	 */
+	int k, var;
+	if(decision_level(s) <= level)
+	{
+		return;
+	}
+	for(k = s->trail_size - 1; k >= s->trail_lim.data[level]; k--)
+	{
+		var = s->trail[k] >> 1;
+		s->polarity[var] = s->assigns[var];
+		s->assigns[var] = VALUE_UNDEF;
+		s->reason[var] = NO_REASON;
+		heap_insert(s,var);
+	}
+	s->trail_size = s->trail_lim.data[level];
+	s->qhead = s->trail_size;
+	s->trail_lim.size = level;
+}
+
+static int store_clause(sat_solver *s, int *lits, int num_lits, BOOL learnt)
+{
+	/*
+	 * Copies the clause to the arena and makes its first two literals watch it. Assumes num_lits >= 2.
+	 * Returns the clause.
+	 */
+	int ref = s->arena.size;
+	int k;
+	push_int(&s->arena,num_lits);
+	push_int(&s->arena,learnt ? LEARNT_FLAG : 0);
+	push_int(&s->arena,-1);
+	for(k = 0; k < num_lits; k++)
+	{
+		push_int(&s->arena,lits[k]);
+	}
+	push_int(s->watches + lits[0],ref);
+	push_int(s->watches + lits[1],ref);
+
+	if(learnt)
+	{
+		if(s->learnts.size == s->learnt_capacity)
+		{
+			s->learnt_capacity = (s->learnt_capacity == 0) ? 64 : 2*s->learnt_capacity;
+			s->learnt_activity = (double*)realloc(s->learnt_activity,s->learnt_capacity*sizeof(double));
+			check_alloc(s->learnt_activity,"store_clause");
+		}
+		CLAUSE_ACTIVITY(s,ref) = s->learnts.size;
+		s->learnt_activity[s->learnts.size] = 0;
+		push_int(&s->learnts,ref);
+	}
+	return ref;
+}
+
+BOOL sat_add_clause(sat_solver *s, int *lits, int num_lits)
+{
+	/*
+	 * Adds the clause lits[0] or ... or lits[num_lits-1] to the formula.
+	 * Returns FALSE if the formula became trivially unsatisfiable (an empty clause, or a unit clause
+	 * that contradicts an earlier one), TRUE otherwise.
+	 */
+	int_vector *clause = &s->learnt_clause;
+	int k, m, lit;
+	BOOL duplicate;
+
+	if(s->unsat)
+	{
+		return FALSE;
+	}
+	cancel_until(s,0);
+	clause->size = 0;
+	for(k = 0; k < num_lits; k++)
+	{
+		lit = to_internal_lit(lits[k]);
+		if(lit_value(s,lit) == TRUE)
+		{/*the clause is already satisfied*/
+			return TRUE;
+		}
+		if(lit_value(s,lit) == FALSE)
+		{/*the literal can't help*/
+			continue;
+		}
+		duplicate = FALSE;
+		for(m = 0; m < clause->size; m++)
+		{
+			if(clause->data[m] == (lit ^ 1))
+			{/*x or not x, always satisfied*/
+				return TRUE;
+			}
+			duplicate = duplicate || (clause->data[m] == lit);
+		}
+		if(!duplicate)
+		{
+			push_int(clause,lit);
+		}
+	}
+
+	if(clause->size == 0)
+	{
+		s->unsat = TRUE;
+		return FALSE;
+	}
+	if(clause->size == 1)
+	{
+		enqueue(s,clause->data[0],NO_REASON);
+		return TRUE;
+	}
+	store_clause(s,clause->data,clause->size,FALSE);
+	return TRUE;
+}
+
+static int propagate(sat_solver *s)
+{
+	/*
+	 * Assigns every literal implied by the literals on the trail that weren't propagated yet.
+	 * Returns a clause whose literals are all false, or NO_REASON if there is no conflict.
+	 */
+	int false_lit, ref, k, i, j;
+	int *lits;
+	int_vector *watchers;
+	BOOL found;
+
+	while(s->qhead < s->trail_size)
+	{
+		false_lit = s->trail[s->qhead++] ^ 1;
+		watchers = s->watches + false_lit;
+		for(i = 0, j = 0; i < watchers->size; i++)
+		{
+			ref = watchers->data[i];
+			if(CLAUSE_FLAGS(s,ref) & DELETED_FLAG)
+			{/*drop the watch of a deleted clause*/
+				continue;
+			}
+			lits = CLAUSE_LITS(s,ref);
+			if(lits[0] == false_lit)
+			{/*keep the false literal second*/
+				lits[0] = lits[1];
+				lits[1] = false_lit;
+			}
+			if(lit_value(s,lits[0]) == TRUE)
+			{/*the clause is satisfied*/
+				watchers->data[j++] = ref;
+				continue;
+			}
+			found = FALSE;
+			for(k = 2; k < CLAUSE_SIZE(s,ref); k++)
+			{
+				if(lit_value(s,lits[k]) != FALSE)
+				{/*watch this literal instead*/
+					lits[1] = lits[k];
+					lits[k] = false_lit;
+					push_int(s->watches + lits[1],ref);
+					found = TRUE;
+					break;
+				}
+			}
+			if(found)
+			{
+				continue;
+			}
+			watchers->data[j++] = ref;
+			if(lit_value(s,lits[0]) == FALSE)
+			{/*every literal is false*/
+				for(i++; i < watchers->size; i++)
+				{
+					watchers->data[j++] = watchers->data[i];
+				}
+				watchers->size = j;
+				s->qhead = s->trail_size;
+				return ref;
+			}
+			enqueue(s,lits[0],ref); /*the clause is unit*/
+		}
+		watchers->size = j;
+	}
+	return NO_REASON;
+}
+
+static void bump_var(sat_solver *s, int var)
+{
+	int k;
+	s->activity[var] += s->var_inc;
+	if(s->activity[var] > RESCALE_LIMIT)
+	{
+		for(k = 0; k < s->num_vars; k++)
+		{
+			s->activity[k] /= RESCALE_LIMIT;
+		}
+		s->var_inc /= RESCALE_LIMIT;
+	}
+	if(s->heap_index[var] != -1)
+	{
+		heap_up(s,s->heap_index[var]);
+	}
+}
+
+static void bump_clause(sat_solver *s, int ref)
+{
+	int k;
+	double *activity = s->learnt_activity + CLAUSE_ACTIVITY(s,ref);
+	*activity += s->clause_inc;
+	if(*activity > RESCALE_LIMIT)
+	{
+		for(k = 0; k < s->learnts.size; k++)
+		{
+			s->learnt_activity[k] /= RESCALE_LIMIT;
+		}
+		s->clause_inc /= RESCALE_LIMIT;
+	}
+}
+
+static BOOL is_redundant(sat_solver *s, int var)
+{
+	/*
+	 * Returns TRUE if the literal of var can be left out of the learnt clause,
+	 * because all the other literals of its reason are already in the clause (or are facts).
+	 */
+	int k, other;
+	int ref = s->reason[var];
+	int *lits;
+	if(ref == NO_REASON)
+	{
+		return FALSE;
+	}
+	lits = CLAUSE_LITS(s,ref);
+	for(k = 1; k < CLAUSE_SIZE(s,ref); k++)
+	{
+		other = lits[k] >> 1;
+		if(!s->seen[other] && s->level[other] > 0)
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static int analyze(sat_solver *s, int conflict)
+{
+	/*
+	 * Learns a clause from the conflict: resolves the conflict with the reasons of the literals of
+	 * the current decision level until a single one is left (the first unique implication point),
+	 * then drops the literals whose reason is covered by the rest of the clause.
+	 * The clause is left in s->learnt_clause, with the literal of the current level first and a literal
+	 * of the highest other level second. Returns the level to backjump to.
+	 */
+	int_vector *learnt = &s->learnt_clause;
+	int path = 0; /*the literals of the current level that weren't resolved yet*/
+	int lit = LIT_UNDEF;
+	int index = s->trail_size - 1;
+	int ref = conflict;
+	int k, j, var, max_k, tmp;
+	int *lits;
+
+	learnt->size = 0;
+	push_int(learnt,LIT_UNDEF); /*the place of the asserting literal*/
+	do
+	{
+		if(CLAUSE_FLAGS(s,ref) & LEARNT_FLAG)
+		{
+			bump_clause(s,ref);
+		}
+		lits = CLAUSE_LITS(s,ref);
+		for(k = (lit == LIT_UNDEF) ? 0 : 1; k < CLAUSE_SIZE(s,ref); k++)
+		{
+			var = lits[k] >> 1;
+			if(!s->seen[var] && s->level[var] > 0)
+			{
+				bump_var(s,var);
+				s->seen[var] = TRUE;
+				if(s->level[var] >= decision_level(s))
+				{
+					path++;
+				}
+				else
+				{
+					push_int(learnt,lits[k]);
+				}
+			}
+		}
+		/*the next literal of the current level to resolve on*/
+		while(!s->seen[s->trail[index] >> 1])
+		{
+			index--;
+		}
+		lit = s->trail[index];
+		index--;
+		ref = s->reason[lit >> 1];
+		s->seen[lit >> 1] = FALSE;
+		path--;
+	}while(path > 0);
+	learnt->data[0] = lit ^ 1;
+
+	/*minimize: the seen marks of the clause are needed until every literal was checked*/
+	s->to_clear.size = 0;
+	for(k = 1; k < learnt->size; k++)
+	{
+		push_int(&s->to_clear,learnt->data[k] >> 1);
+	}
+	for(k = 1, j = 1; k < learnt->size; k++)
+	{
+		if(!is_redundant(s,learnt->data[k] >> 1))
+		{
+			learnt->data[j++] = learnt->data[k];
+		}
+	}
+	learnt->size = j;
+	for(k = 0; k < s->to_clear.size; k++)
+	{
+		s->seen[s->to_clear.data[k]] = FALSE;
+	}
+
+	if(learnt->size == 1)
+	{
+		return 0;
+	}
+	max_k = 1;
+	for(k = 2; k < learnt->size; k++)
+	{
+		if(s->level[learnt->data[k] >> 1] > s->level[learnt->data[max_k] >> 1])
+		{
+			max_k = k;
+		}
+	}
+	tmp = learnt->data[1];
+	learnt->data[1] = learnt->data[max_k];
+	learnt->data[max_k] = tmp;
+	return s->level[learnt->data[1] >> 1];
+}
+
+typedef struct learnt_entry_struct
+{
+	double activity;
+	int ref;
+}learnt_entry;
+
+static int compare_learnts(const void *a, const void *b)
+{
+	double x = ((const learnt_entry*)a)->activity;
+	double y = ((const learnt_entry*)b)->activity;
+	return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+static void reduce_learnts(sat_solver *s)
+{
+	/*
+	 * Deletes the less active half of the learnt clauses, except binary clauses and current reasons.
+	 * Deleted clauses stay in the arena, and their watches are dropped by propagate.
+	 */
+	int n = s->learnts.size;
+	int k, ref, kept = 0;
+	int *lits;
+	learnt_entry *entries = (learnt_entry*)malloc(n*sizeof(learnt_entry));
+	check_alloc(entries,"reduce_learnts");
+
+	for(k = 0; k < n; k++)
+	{
+		entries[k].ref = s->learnts.data[k];
+		entries[k].activity = s->learnt_activity[CLAUSE_ACTIVITY(s,entries[k].ref)];
+	}
+	qsort(entries,n,sizeof(learnt_entry),compare_learnts);
+
+	for(k = 0; k < n; k++)
+	{
+		ref = entries[k].ref;
+		lits = CLAUSE_LITS(s,ref);
+		if(k < n/2 && CLAUSE_SIZE(s,ref) > 2
+				&& !(s->reason[lits[0] >> 1] == ref && lit_value(s,lits[0]) == TRUE))
+		{
+			CLAUSE_FLAGS(s,ref) |= DELETED_FLAG;
+			continue;
+		}
+		CLAUSE_ACTIVITY(s,ref) = kept;
+		s->learnt_activity[kept] = entries[k].activity;
+		s->learnts.data[kept] = ref;
+		kept++;
+	}
+	s->learnts.size = kept;
+	free(entries);
+}
+
+static int luby(int x)
+{
+	/*
+	 * Returns the x-th element (from 0) of the Luby sequence 1,1,2,1,1,2,4,1,1,2,1,1,2,4,8,...
+	 */
+	int size = 1, seq = 0;
+	while(size < x + 1)
+	{
+		seq++;
+		size = 2*size + 1;
+	}
+	while(size - 1 != x)
+	{
+		size = (size - 1) >> 1;
+		seq--;
+		x = x % size;
+	}
+	return 1 << seq;
+}
+
+static int pick_branch_lit(sat_solver *s)
+{
+	/*
+	 * Returns the unassigned variable with the highest activity, with its saved phase,
+	 * or LIT_UNDEF if every variable is assigned.
+	 */
+	int var;
+	while(s->heap_size > 0)
+	{
+		var = heap_remove_max(s);
+		if(s->assigns[var] == VALUE_UNDEF)
+		{
+			return 2*var + (s->polarity[var] ? 0 : 1);
+		}
+	}
+	return LIT_UNDEF;
+}
+
+BOOL sat_solve(sat_solver *s, cancel_token *token)
+{
+	/*
+	 * Searches for an assignment that satisfies all the clauses.
+	 * Returns TRUE if one was found (read it with sat_value), FALSE if the formula is unsatisfiable,
+	 * or CANCELLED if token (may be NULL) was cancelled before the search ended.
+	 * Clauses can be added again after the function returns.
+	 */
+	return sat_solve_assuming(s,NULL,0,token);
+}
+
+BOOL sat_solve_assuming(sat_solver *s, int *assumptions, int num_assumptions, cancel_token *token)
+{
+	/*
+	 * Like sat_solve, but only searches for assignments where the literals assumptions[0..num_assumptions-1] are true.
+	 * Returns FALSE if there is no such assignment. The assumptions are not added to the formula,
+	 * and the clauses learnt on the way are kept, so the solver can be called again with other assumptions
+	 * and reuses what it learnt.
+	 * The k-th assumption is the decision of level k+1, so backjumps and restarts below it make it again.
+	 */
+	int conflict, level, lit, var, ref;
+	int restarts = 0, conflicts = 0;
+	int steps = 0; /*the decisions and conflicts since the token was last checked*/
+	int restart_limit = RESTART_BASE*luby(0);
+
+	if(s->unsat)
+	{
+		return FALSE;
+	}
+	while(TRUE)
+	{
+		if(++steps == CANCEL_CHECK_INTERVAL)
+		{
+			steps = 0;
+			if(is_cancelled(token))
+			{
+				cancel_until(s,0);
+				return CANCELLED;
+			}
+		}
+		conflict = propagate(s);
+		if(conflict != NO_REASON)
+		{
+			conflicts++;
+			if(decision_level(s) == 0)
+			{/*the conflict doesn't depend on any decision*/
+				s->unsat = TRUE;
+				return FALSE;
+			}
+			level = analyze(s,conflict);
+			cancel_until(s,level);
+			if(s->learnt_clause.size == 1)
+			{
+				enqueue(s,s->learnt_clause.data[0],NO_REASON);
+			}
+			else
+			{
+				ref = store_clause(s,s->learnt_clause.data,s->learnt_clause.size,TRUE);
+				bump_clause(s,ref);
+				enqueue(s,s->learnt_clause.data[0],ref);
+			}
+			s->var_inc /= VAR_DECAY;
+			s->clause_inc /= CLAUSE_DECAY;
+			continue;
+		}
+
+		if(conflicts >= restart_limit)
+		{
+			cancel_until(s,0);
+			restarts++;
+			conflicts = 0;
+			restart_limit = RESTART_BASE*luby(restarts);
+		}
+		if(s->learnts.size - s->trail_size >= s->max_learnts)
+		{
+			reduce_learnts(s);
+			s->max_learnts += s->max_learnts/10;
+		}
+
+		lit = LIT_UNDEF;
+		while(decision_level(s) < num_assumptions && lit == LIT_UNDEF)
+		{
+			lit = to_internal_lit(assumptions[decision_level(s)]);
+			if(lit_value(s,lit) == FALSE)
+			{/*the formula implies the negation of the assumptions made so far*/
+				cancel_until(s,0);
+				return FALSE;
+			}
+			if(lit_value(s,lit) == TRUE)
+			{/*already implied, its level stays empty*/
+				push_int(&s->trail_lim,s->trail_size);
+				lit = LIT_UNDEF;
+			}
+		}
+		if(lit == LIT_UNDEF)
+		{
+			lit = pick_branch_lit(s);
+		}
+		if(lit == LIT_UNDEF)
+		{/*every variable is assigned and no clause is false*/
+			for(var = 0; var < s->num_vars; var++)
+			{
+				s->model[var] = s->assigns[var];
+			}
+			cancel_until(s,0);
+			return TRUE;
+		}
+		push_int(&s->trail_lim,s->trail_size);
+		enqueue(s,lit,NO_REASON);
+	}
+}
+
+BOOL sat_value(sat_solver *s, int var)
+{
+	/*
+	 * Returns the value of var (TRUE or FALSE) in the assignment found by the last successful sat_solve.
+	 */
+	return s->model[var-1];
+}
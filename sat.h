@@ -0,0 +1,56 @@
+#ifndef SAT_H_
+#define SAT_H_
+
+#include "definitions.h"
+#include "cancel.h"
+
+/*
+ * This module is a CDCL SAT solver: it decides whether a formula in conjunctive normal form is satisfiable.
+ * It uses two watched literals per clause for propagation, learns a clause at the first unique implication point
+ * of every conflict, picks decisions by VSIDS activity with saved phases, and restarts on the Luby sequence.
+ * Variables are numbered from 1, and a literal is a variable (true) or its negation (false), like in DIMACS.
+ */
+
+typedef struct sat_solver_struct sat_solver;
+
+/*
+ * Allocates a solver for a formula over the variables 1...num_vars, with no clauses.
+ * Uses malloc, free it with free_sat_solver.
+ * Terminates the program on a memory allocation error.
+ */
+sat_solver* new_sat_solver(int num_vars);
+
+/*
+ * Frees all memory of s. s may be NULL.
+ */
+void free_sat_solver(sat_solver *s);
+
+/*
+ * Adds the clause lits[0] or ... or lits[num_lits-1] to the formula.
+ * Returns FALSE if the formula became trivially unsatisfiable (an empty clause, or a unit clause
+ * that contradicts an earlier one), TRUE otherwise.
+ */
+BOOL sat_add_clause(sat_solver *s, int *lits, int num_lits);
+
+/*
+ * Searches for an assignment that satisfies all the clauses.
+ * Returns TRUE if one was found (read it with sat_value), FALSE if the formula is unsatisfiable,
+ * or CANCELLED if token (may be NULL) was cancelled before the search ended.
+ * Clauses can be added again after the function returns.
+ */
+BOOL sat_solve(sat_solver *s, cancel_token *token);
+
+/*
+ * Like sat_solve, but only searches for assignments where the literals assumptions[0..num_assumptions-1] are true.
+ * Returns FALSE if there is no such assignment. The assumptions are not added to the formula,
+ * and the clauses learnt on the way are kept, so the solver can be called again with other assumptions
+ * and reuses what it learnt.
+ */
+BOOL sat_solve_assuming(sat_solver *s, int *assumptions, int num_assumptions, cancel_token *token);
+
+/*
+ * Returns the value of var (TRUE or FALSE) in the assignment found by the last successful sat_solve.
+ */
+BOOL sat_value(sat_solver *s, int var);
+
+#endif /* SAT_H_ */
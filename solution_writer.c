@@ -0,0 +1,189 @@
+#include <stdlib.h>
+#include <string.h>
+#include "solution_writer.h"
+#include "main_aux.h"
+
+/*
+ * This module streams the solutions of a board to a binary file, straight from the search.
+ * The output is buffered, and every digit takes only as many bits as the board needs.
+ * See solution_writer.h for the file format.
+ */
+
+#define WRITER_BUFFER_SIZE (1 << 16) /*the bytes collected before they are written to the file*/
+
+struct solution_writer_struct
+{
+	FILE *file;
+	BOOL delta;
+	BOOL failed; /*TRUE once writing to the file failed*/
+	int num_cells;
+	int digit_bits; /*the bits of a digit-1*/
+	int cell_bits; /*the bits of a cell index*/
+	int count_bits; /*the bits of the number of changed cells*/
+	int *previous; /*the last solution written*/
+	int num_written;
+	unsigned long pending; /*the lowest num_pending bits weren't put in the buffer yet*/
+	int num_pending;
+	int buffer_size;
+	unsigned char buffer[WRITER_BUFFER_SIZE];
+};
+
+static int bits_for(int x)
+{
+	/*
+	 * Returns the number of bits needed to write the numbers 0...x (at least 1).
+	 */
+	int bits = 1;
+	while((x >> bits) != 0)
+	{
+		bits++;
+	}
+	return bits;
+}
+
+static void flush_buffer(solution_writer *w)
+{
+	/*
+	 * Writes the buffer of w to its file and empties it.
+	 */
+	if(w->buffer_size > 0 && fwrite(w->buffer,1,w->buffer_size,w->file) != (size_t)w->buffer_size)
+	{
+		w->failed = TRUE;
+	}
+	w->buffer_size = 0;
+}
+
+static void put_byte(solution_writer *w, int byte)
+{
+	/*
+	 * Adds byte to the buffer of w, which is written to the file when it is full.
+	 */
+	if(w->buffer_size == WRITER_BUFFER_SIZE)
+	{
+		flush_buffer(w);
+	}
+	w->buffer[w->buffer_size++] = (unsigned char)byte;
+}
+
+static void put_bits(solution_writer *w, int value, int num_bits)
+{
+	/*
+	 * Adds the lowest num_bits bits of value (num_bits <= 16), most significant first.
+	 */
+	w->pending = (w->pending << num_bits) | (unsigned long)value;
+	w->num_pending += num_bits;
+	while(w->num_pending >= 8)
+	{
+		w->num_pending -= 8;
+		put_byte(w,(int)((w->pending >> w->num_pending) & 0xFF));
+	}
+}
+
+static void end_record(solution_writer *w)
+{
+	/*
+	 * Pads the current record with zero bits to a whole byte.
+	 */
+	if(w->num_pending > 0)
+	{
+		put_bits(w,0,8 - w->num_pending);
+	}
+}
+
+solution_writer* new_solution_writer(FILE *f, sudoku_board *board, BOOL delta)
+{
+	/*
+	 * Allocates a writer of the solutions of board to the file f, opened for binary writing, and writes the header.
+	 * If delta is TRUE, each solution is written as its difference from the previous one.
+	 * Uses malloc, free it with close_solution_writer.
+	 * Terminates the program on a memory allocation error.
+	 */
+	solution_writer *w = (solution_writer*)malloc(sizeof(solution_writer));
+	int length = board->length;
+	check_alloc(w,"new_solution_writer");
+	w->file = f;
+	w->delta = delta;
+	w->failed = FALSE;
+	w->num_cells = length*length;
+	w->digit_bits = bits_for(length-1);
+	w->cell_bits = bits_for(w->num_cells-1);
+	w->count_bits = bits_for(w->num_cells);
+	w->previous = (int*)malloc(w->num_cells*sizeof(int));
+	check_alloc(w->previous,"new_solution_writer");
+	w->num_written = 0;
+	w->pending = 0;
+	w->num_pending = 0;
+	w->buffer_size = 0;
+
+	put_byte(w,'S');
+	put_byte(w,'D');
+	put_byte(w,'K');
+	put_byte(w,'E');
+	put_byte(w,board->block_vertical);
+	put_byte(w,board->block_horizontal);
+	put_byte(w,delta ? 1 : 0);
+	return w;
+}
+
+BOOL write_solution(candidates *c, void *data)
+{
+	/*
+	 * Writes the solution filled in c->grid to the writer data. Can be given to enumerate_solutions as the visitor.
+	 * Returns FALSE if writing to the file failed, so the enumeration stops, TRUE otherwise.
+	 */
+	solution_writer *w = (solution_writer*)data;
+	int cell, num_changed = 0;
+
+	if(!w->delta || w->num_written == 0)
+	{
+		for(cell = 0; cell < w->num_cells; cell++)
+		{
+			put_bits(w,c->grid[cell]-1,w->digit_bits);
+		}
+	}
+	else
+	{
+		for(cell = 0; cell < w->num_cells; cell++)
+		{
+			num_changed += (c->grid[cell] != w->previous[cell]);
+		}
+		put_bits(w,num_changed,w->count_bits);
+		for(cell = 0; cell < w->num_cells; cell++)
+		{
+			if(c->grid[cell] != w->previous[cell])
+			{
+				put_bits(w,cell,w->cell_bits);
+				put_bits(w,c->grid[cell]-1,w->digit_bits);
+			}
+		}
+	}
+	end_record(w);
+	if(w->delta)
+	{
+		memcpy(w->previous,c->grid,w->num_cells*sizeof(int));
+	}
+	w->num_written++;
+	return !w->failed;
+}
+
+int get_solutions_written(solution_writer *writer)
+{
+	/*
+	 * Returns the number of solutions written by writer so far.
+	 */
+	return writer->num_written;
+}
+
+BOOL close_solution_writer(solution_writer *writer)
+{
+	/*
+	 * Writes what is left in the buffer of writer to its file and frees writer. Doesn't close the file.
+	 * Returns TRUE if every byte was written successfully, FALSE otherwise.
+	 */
+	BOOL written;
+	flush_buffer(writer);
+	written = !writer->failed && fflush(writer->file) == 0;
+	free(writer->previous);
+	free(writer);
+	return written;
+}
@@ -0,0 +1,49 @@
+#ifndef SOLUTION_WRITER_H_
+#define SOLUTION_WRITER_H_
+
+#include <stdio.h>
+#include "definitions.h"
+#include "candidates.h"
+
+/*
+ * This module streams the solutions of a board to a binary file, straight from the search.
+ * The output is buffered, and every digit takes only as many bits as the board needs.
+ *
+ * The file format:
+ * A header of 7 bytes: "SDKE", block_vertical, block_horizontal, and the flags (1 if delta encoded, 0 otherwise).
+ * Then one record per solution, each starting on a new byte and written most significant bit first.
+ * With D the bits needed for length-1, C the bits needed for length*length-1 and N the bits needed for length*length:
+ *  A full record is the digit-1 of every cell in D bits, row by row.
+ *  A delta record is the number of cells that differ from the previous solution in N bits, followed by
+ *  the index (row*length + column, from 0) of each such cell in C bits and its digit-1 in D bits.
+ * Without delta encoding every record is full. With it, only the first record is full.
+ */
+
+typedef struct solution_writer_struct solution_writer;
+
+/*
+ * Allocates a writer of the solutions of board to the file f, opened for binary writing, and writes the header.
+ * If delta is TRUE, each solution is written as its difference from the previous one.
+ * Uses malloc, free it with close_solution_writer.
+ * Terminates the program on a memory allocation error.
+ */
+solution_writer* new_solution_writer(FILE *f, sudoku_board *board, BOOL delta);
+
+/*
+ * Writes the solution filled in c->grid to the writer data. Can be given to enumerate_solutions as the visitor.
+ * Returns FALSE if writing to the file failed, so the enumeration stops, TRUE otherwise.
+ */
+BOOL write_solution(candidates *c, void *data);
+
+/*
+ * Returns the number of solutions written by writer so far.
+ */
+int get_solutions_written(solution_writer *writer);
+
+/*
+ * Writes what is left in the buffer of writer to its file and frees writer. Doesn't close the file.
+ * Returns TRUE if every byte was written successfully, FALSE otherwise.
+ */
+BOOL close_solution_writer(solution_writer *writer);
+
+#endif /* SOLUTION_WRITER_H_ */
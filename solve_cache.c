@@ -0,0 +1,258 @@
+#include "solve_cache.h"
+#include "groups.h"
+#include "cages.h"
+
+/*
+ * This module remembers what the solvers found out about the cells of the board, so asking again about the same cells
+ * (a hint after a hint, saving after validating, counting the solutions twice) doesn't solve them again.
+ * The results are kept for one state of the cells, found by the key the pencil marks keep (see get_board_key)
+ * and confirmed by comparing the cells, so they stop being used as soon as a cell changes, and are used again
+ * if the cells change back before other cells are solved.
+ */
+
+static BOOL are_equal(int **M, int **N, int length)
+{
+	/*
+	 * Returns TRUE if the length*length matrices M and N hold the same values, FALSE otherwise.
+	 */
+	int i, j;
+	for(i = 0; i < length; i++)
+	{
+		for(j = 0; j < length; j++)
+		{
+			if(M[i][j] != N[i][j])
+			{
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void forget_results(solve_cache *cache)
+{
+	/*
+	 * Forgets all the results of cache, which are not known for its cells anymore.
+	 */
+	cache->solvable = ERROR;
+	free_matrix(cache->forced,cache->length);
+	cache->forced = NULL;
+	cache->count = ERROR;
+	cache->count_limit = NO_LIMIT;
+	free(cache->total);
+	cache->total = NULL;
+}
+
+solve_cache* get_solve_cache(sudoku_board *board)
+{
+	/*
+	 * Returns the results remembered for the cells of board, which are empty if they are for other cells.
+	 * Makes board->cache on the first call, free it with free_solve_cache when the groups or the cages of the board change.
+	 * Assumes board is initialized and board->marks is not NULL.
+	 * Terminates the program on a memory allocation error.
+	 */
+	solve_cache *cache = board->cache;
+	unsigned long key = get_board_key(board);
+	if(cache == NULL)
+	{
+		cache = (solve_cache*)malloc(sizeof(solve_cache));
+		check_alloc(cache,"get_solve_cache");
+		cache->length = board->length;
+		cache->cells = make_matrix(board->length);
+		cache->solution = make_matrix(board->length);
+		cache->forced = NULL;
+		cache->total = NULL;
+		forget_results(cache);
+		copy_matrix(board->cells,cache->cells,board->length);
+		cache->key = key;
+		board->cache = cache;
+	}
+	else if(cache->key != key || !are_equal(cache->cells,board->cells,board->length))
+	{/*the results are for other cells*/
+		forget_results(cache);
+		copy_matrix(board->cells,cache->cells,board->length);
+		cache->key = key;
+	}
+	return cache;
+}
+
+int get_cached_solvability(sudoku_board *board)
+{
+	/*
+	 * Returns what board->cache knows about the cells of board: TRUE or FALSE if they are solvable or unsolvable,
+	 * ERROR if that isn't known. Unlike get_solve_cache, keeps the results of other cells, so checking between
+	 * the moves doesn't lose them before the cells change back.
+	 * Assumes board is initialized and board->marks is not NULL.
+	 */
+	solve_cache *cache = board->cache;
+	if(cache == NULL || cache->key != get_board_key(board) || !are_equal(cache->cells,board->cells,board->length))
+	{
+		return ERROR;
+	}
+	return cache->solvable;
+}
+
+void free_solve_cache(solve_cache *cache)
+{
+	/*
+	 * Frees all memory of cache. cache may be NULL.
+	 */
+	if(cache != NULL)
+	{
+		forget_results(cache);
+		free_matrix(cache->cells,cache->length);
+		free_matrix(cache->solution,cache->length);
+		free(cache);
+	}
+}
+
+void remember_solution(solve_cache *cache, int **solution)
+{
+	/*
+	 * Remembers that the cells of cache are solved by solution.
+	 */
+	cache->solvable = TRUE;
+	copy_matrix(solution,cache->solution,cache->length);
+}
+
+void remember_unsolvable(solve_cache *cache)
+{
+	/*
+	 * Remembers that the cells of cache have no solution.
+	 */
+	cache->solvable = FALSE;
+}
+
+void remember_backbone(solve_cache *cache, int **forced, int **solution)
+{
+	/*
+	 * Remembers the backbone forced of the cells of cache (see find_backbone) and their solution solution.
+	 * Terminates the program on a memory allocation error.
+	 */
+	remember_solution(cache,solution);
+	if(cache->forced == NULL)
+	{
+		cache->forced = make_matrix(cache->length);
+	}
+	copy_matrix(forced,cache->forced,cache->length);
+}
+
+void remember_count(solve_cache *cache, int count, int limit)
+{
+	/*
+	 * Remembers that count_solutions_bounded with limit returned count (not CANCELLED) for the cells of cache.
+	 * A count that tells less than the one remembered is dropped. No solutions at all makes the cells unsolvable.
+	 */
+	if(get_cached_count(cache,limit) != ERROR)
+	{/*the count remembered already tells as much*/
+		return;
+	}
+	cache->count = count;
+	cache->count_limit = limit;
+	if(count == 0)
+	{
+		cache->solvable = FALSE;
+	}
+}
+
+void remember_total(solve_cache *cache, char *total)
+{
+	/*
+	 * Remembers the number of solutions of cells with INT_MAX solutions or more, written out in total.
+	 * Terminates the program on a memory allocation error.
+	 */
+	free(cache->total);
+	cache->total = (char*)malloc(strlen(total)+1);
+	check_alloc(cache->total,"remember_total");
+	strcpy(cache->total,total);
+}
+
+int get_cached_count(solve_cache *cache, int limit)
+{
+	/*
+	 * Returns what count_solutions_bounded with limit would return for the cells of cache, if it follows from
+	 * the counts remembered, ERROR otherwise.
+	 * count_solutions_bounded stops at the limit, and at INT_MAX without one: a count below where it stopped is exact,
+	 * and a count where it stopped is a lower bound, which still answers a smaller limit.
+	 */
+	int bound = (cache->count_limit == NO_LIMIT) ? INT_MAX : cache->count_limit;
+	if(cache->count == ERROR)
+	{
+		return ERROR;
+	}
+	if(cache->count < bound)
+	{/*exact*/
+		return (limit == NO_LIMIT || cache->count < limit) ? cache->count : limit;
+	}
+	if(limit != NO_LIMIT && limit <= cache->count)
+	{
+		return limit;
+	}
+	if(limit == NO_LIMIT && cache->count == INT_MAX)
+	{
+		return INT_MAX;
+	}
+	return ERROR;
+}
+
+BOOL solution_fits_board(sudoku_board *board)
+{
+	/*
+	 * Returns TRUE if board->solution is a solution of the cells of board: it is full, it holds every filled cell,
+	 * no group repeats a digit and every cage adds up to its sum. FALSE otherwise.
+	 * board->solution may hold the solution of earlier cells, which still solves the cells if they didn't move away from it.
+	 * Assumes board is initialized.
+	 */
+	group_table *groups = board->groups;
+	cage_table *cages = board->cages;
+	int length = board->length;
+	int i, j, g, k, cell, digit, sum;
+	MASK seen;
+
+	for(i = 0; i < length; i++)
+	{
+		for(j = 0; j < length; j++)
+		{
+			digit = board->solution[i][j];
+			if(digit < 1 || digit > length || (board->cells[i][j] != 0 && board->cells[i][j] != digit))
+			{
+				return FALSE;
+			}
+		}
+	}
+	for(g = 0; g < groups->num_groups; g++)
+	{
+		seen = 0;
+		for(k = 0; k < length; k++)
+		{
+			cell = groups->cells[g*length + k];
+			digit = board->solution[cell%length][cell/length];
+			if(seen & DIGIT_BIT(digit))
+			{
+				return FALSE;
+			}
+			seen |= DIGIT_BIT(digit);
+		}
+	}
+	for(g = 0; cages != NULL && g < cages->num_cages; g++)
+	{
+		seen = 0;
+		sum = 0;
+		for(k = cages->first_cell[g]; k < cages->first_cell[g+1]; k++)
+		{
+			cell = cages->cells[k];
+			digit = board->solution[cell%length][cell/length];
+			if(seen & DIGIT_BIT(digit))
+			{
+				return FALSE;
+			}
+			seen |= DIGIT_BIT(digit);
+			sum += digit;
+		}
+		if(sum != cages->sum[g])
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
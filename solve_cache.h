@@ -0,0 +1,95 @@
+#ifndef SOLVE_CACHE_H_
+#define SOLVE_CACHE_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "definitions.h"
+#include "main_aux.h"
+#include "matrix.h"
+#include "pencil.h"
+
+/*
+ * This module remembers what the solvers found out about the cells of the board, so asking again about the same cells
+ * (a hint after a hint, saving after validating, counting the solutions twice) doesn't solve them again.
+ * The results are kept for one state of the cells, found by the key the pencil marks keep (see get_board_key)
+ * and confirmed by comparing the cells, so they stop being used as soon as a cell changes, and are used again
+ * if the cells change back before other cells are solved.
+ */
+
+typedef struct solve_cache_struct
+{
+	int length;
+	unsigned long key; /*the key of the cells the results are for, see get_board_key*/
+	int **cells; /*the cells the results are for, to tell them from other cells with the same key*/
+	int solvable; /*TRUE or FALSE, ERROR if not known*/
+	int **solution; /*a solution of the cells, if solvable is TRUE*/
+	int **forced; /*the backbone of the cells (see find_backbone), NULL if not known*/
+	int count; /*the number of solutions counted up to count_limit (see count_solutions_bounded), ERROR if not known*/
+	int count_limit;
+	char *total; /*the number of solutions written out (see bigint_to_string), of cells with INT_MAX solutions or more.
+				  *NULL if not known*/
+}solve_cache;
+
+/*
+ * Returns the results remembered for the cells of board, which are empty if they are for other cells.
+ * Makes board->cache on the first call, free it with free_solve_cache when the groups or the cages of the board change.
+ * Assumes board is initialized and board->marks is not NULL.
+ * Terminates the program on a memory allocation error.
+ */
+solve_cache* get_solve_cache(sudoku_board *board);
+
+/*
+ * Returns what board->cache knows about the cells of board: TRUE or FALSE if they are solvable or unsolvable,
+ * ERROR if that isn't known. Unlike get_solve_cache, keeps the results of other cells.
+ * Assumes board is initialized and board->marks is not NULL.
+ */
+int get_cached_solvability(sudoku_board *board);
+
+/*
+ * Frees all memory of cache. cache may be NULL.
+ */
+void free_solve_cache(solve_cache *cache);
+
+/*
+ * Remembers that the cells of cache are solved by solution.
+ */
+void remember_solution(solve_cache *cache, int **solution);
+
+/*
+ * Remembers that the cells of cache have no solution.
+ */
+void remember_unsolvable(solve_cache *cache);
+
+/*
+ * Remembers the backbone forced of the cells of cache (see find_backbone) and their solution solution.
+ * Terminates the program on a memory allocation error.
+ */
+void remember_backbone(solve_cache *cache, int **forced, int **solution);
+
+/*
+ * Remembers that count_solutions_bounded with limit returned count (not CANCELLED) for the cells of cache.
+ */
+void remember_count(solve_cache *cache, int count, int limit);
+
+/*
+ * Remembers the number of solutions of cells with INT_MAX solutions or more, written out in total.
+ * Terminates the program on a memory allocation error.
+ */
+void remember_total(solve_cache *cache, char *total);
+
+/*
+ * Returns what count_solutions_bounded with limit would return for the cells of cache, if it follows from
+ * the counts remembered, ERROR otherwise.
+ */
+int get_cached_count(solve_cache *cache, int limit);
+
+/*
+ * Returns TRUE if board->solution is a solution of the cells of board: it is full, it holds every filled cell,
+ * no group repeats a digit and every cage adds up to its sum. FALSE otherwise.
+ * board->solution may hold the solution of earlier cells, which still solves the cells if they didn't move away from it.
+ * Assumes board is initialized.
+ */
+BOOL solution_fits_board(sudoku_board *board);
+
+#endif /* SOLVE_CACHE_H_ */
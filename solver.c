@@ -1,27 +1,9 @@
 #include "solver.h"
 
 /*
- * This module solves the Sudoku board using exhaustive backtracking, LP or ILP.
+ * This module solves the Sudoku board using exhaustive backtracking, Dancing Links, SAT, LP or ILP.
  */
 
-/*
- * A constant that says if gurobi encountered an error during the recent LP or ILP.
- * Useful when the function that uses Gurobi doesn't return ERROR on error.
- */
-BOOL GRBERROR = FALSE;
-
-/*
- * An array representing a 3D matrix. Cell ijk contains the index 'ind'
- * of the gurobi variables vector in which the corresponding gurobi variable is found.
- * Meaning gurobi_vars[ind] is 1 if the cell ij contains k. 0 otherwise.
- */
-int* ijk_to_gurobi;
-
-/*
- * A linked list of ijk values ordered according to their placement in the gurobi vector.
- */
-LINKEDLIST gurobi_to_ijk = NULL;
-
 LINKEDLIST get_possible_values(sudoku_board *board, int i, int j,
 		BOOL is_deterministic) {
 	/*
@@ -46,106 +28,1071 @@ LINKEDLIST get_possible_values(sudoku_board *board, int i, int j,
 	return values;
 }
 
-int next_cell_i(int i, int length) {
+/*
+ * Returned by search_completions when it used up its search nodes.
+ */
+#define OUT_OF_NODES (-3)
+
+/*
+ * propose_solution counts a subtree only if that takes fewer than this many search nodes.
+ */
+#define SAMPLE_COUNT_NODES (1024)
+
+/*
+ * search_completions checks its token every CANCEL_CHECK_INTERVAL search nodes on boards of up to this many cells,
+ * and more often on bigger boards, down to every node, in proportion to the square of the number of cells.
+ * A search node takes much longer on a big board (about 12 microseconds on a 25x25 board, where the checks come
+ * every 17 nodes, and up to milliseconds on a 49x49 board), and the checks must keep deadlines of a millisecond.
+ */
+#define CHECK_INTERVAL_CELLS (81)
+
+/*
+ * find_completion gives its first search this many search nodes per empty cell before restarting it.
+ */
+#define RESTART_NODES_PER_CELL (1)
+
+static int search_completions(candidates *c, int limit, int max_nodes, BOOL keep_last, solution_visitor visit, void *data, cancel_token *token)
+{
+	/*
+	 * Counts and returns the number of ways to complete the grid in c using exhaustive backtracking.
+	 * If limit is not NO_LIMIT, the search stops as soon as limit solutions were found and limit is returned.
+	 * limit NO_LIMIT stops at INT_MAX solutions the same way, so the count never overflows.
+	 * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+	 * The search runs on the frame stack of c (c->frames), so it allocates no memory of its own (only the
+	 * transposition table c->memo, if any, may grow as counts are stored), and the searches
+	 * on one candidates structure can't be nested.
+	 * At each node the forced cells (naked and hidden singles) are filled first, then the empty cell
+	 * with the fewest candidates is branched on. Every placement goes on the trail,
+	 * so backtracking is undoing the trail to the mark of the node.
+	 * c is restored to its state at the call when the function returns, except when the search stopped
+	 * at the limit and keep_last is TRUE: then c is left filled with the last solution found.
+	 * If visit is not NULL, it is called with data on every solution, and the search stops like at the limit
+	 * when it returns FALSE.
+	 * Returns CANCELLED if token was cancelled before the search ended, or OUT_OF_NODES if max_nodes isn't NO_LIMIT
+	 * and the search visited max_nodes nodes before it ended (c is restored in both cases).
+	 * If c has a transposition table and the solutions themselves aren't needed (keep_last is FALSE and visit is NULL),
+	 * the count of every subtree that was searched to its end is stored in the table, under the key of the
+	 * constraints at its root, and a subtree whose key is found there isn't searched again.
+	 */
+	int num_solutions = 0;
+	int depth = 0, digit;
+	int base = c->num_placed; /*the trail at the call, restored when stopping at the limit*/
+	int nodes = 0; /*the search nodes since the token was last checked*/
+	int check_interval = (c->num_cells > CHECK_INTERVAL_CELLS)
+			? CANCEL_CHECK_INTERVAL*CHECK_INTERVAL_CELLS/c->num_cells*CHECK_INTERVAL_CELLS/c->num_cells
+			: CANCEL_CHECK_INTERVAL; /*the search nodes between two checks of token, 0 checks every node*/
+	unsigned long total_nodes = 0; /*the search nodes since the call*/
+	BOOL descend = TRUE; /*TRUE when entering a new depth, FALSE when coming back to try the next digit*/
+	BOOL consistent;
+	search_frame *frame = c->frames; /*the node of the current depth*/
+	transposition_table *memo = (keep_last || visit != NULL) ? NULL : c->memo;
+	int k, memo_count;
+
+	if(limit == NO_LIMIT)
+	{
+		limit = INT_MAX;
+	}
+	while(TRUE)
+	{
+		if(descend)
+		{
+			if(++nodes >= check_interval)
+			{
+				nodes = 0;
+				if(is_cancelled(token))
+				{
+					undo_trail(c,base);
+					num_solutions = CANCELLED;
+					break;
+				}
+			}
+			if(++total_nodes == (unsigned long)max_nodes)
+			{
+				undo_trail(c,base);
+				num_solutions = OUT_OF_NODES;
+				break;
+			}
+			if(c->num_placed == c->num_empty)
+			{/*all the cells are filled with legal values, new solution has been found!*/
+				num_solutions++;
+				if(num_solutions == limit || (visit != NULL && !visit(c,data)))
+				{/*enough solutions were found*/
+					if(!keep_last)
+					{
+						undo_trail(c,base);
+					}
+					break;
+				}
+				descend = FALSE;
+				continue;
+			}
+			frame = c->frames + depth;
+			if(memo != NULL)
+			{
+				if(lookup_count(memo,c->key,&memo_count))
+				{/*the subtree was counted before*/
+					if(memo_count >= limit - num_solutions)
+					{
+						num_solutions = limit;
+						undo_trail(c,base);
+						break;
+					}
+					num_solutions += memo_count;
+					descend = FALSE;
+					continue;
+				}
+				frame->solutions_before = num_solutions;
+				frame->nodes_before = total_nodes;
+				for(k = 0; k < KEY_WORDS; k++)
+				{
+					frame->key[k] = c->key[k];
+				}
+			}
+			frame->cell = c->order[c->num_placed + most_constrained_cell(c,c->order+c->num_placed,c->num_empty-c->num_placed)];
+			frame->mark = c->num_placed;
+			frame->remaining = get_cell_candidates(c,frame->cell);
+		}
+		else
+		{
+			if(depth == 0)
+			{/*the whole tree was searched*/
+				break;
+			}
+			depth--;
+			frame = c->frames + depth;
+		}
+
+		/*try the next digit of frame->cell that doesn't lead to a contradiction*/
+		consistent = FALSE;
+		while(!consistent && frame->remaining != 0)
+		{
+			undo_trail(c,frame->mark); /*undo the digit tried last time and everything it forced*/
+			digit = lowest_digit(frame->remaining);
+			frame->remaining &= ~DIGIT_BIT(digit); /*we'll try the next digit next time*/
+			assign_digit(c,frame->cell,digit);
+			consistent = propagate(c);
+		}
+		if(!consistent)
+		{/*all the digits were tried: "return"*/
+			undo_trail(c,frame->mark);
+			if(memo != NULL)
+			{
+				store_count(memo,frame->key,num_solutions-frame->solutions_before,total_nodes-frame->nodes_before);
+			}
+			descend = FALSE;
+			continue;
+		}
+		/*"the recursive call"*/
+		depth++;
+		descend = TRUE;
+	}
+	return num_solutions;
+}
+
+int count_completions(candidates *c, int limit, cancel_token *token)
+{
+	/*
+	 * Counts and returns the number of ways to complete the grid in c using exhaustive backtracking.
+	 * If limit is not NO_LIMIT, the search stops as soon as limit solutions were found and limit is returned.
+	 * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+	 * If c->memo isn't NULL, the counts of searched subtrees are stored in it and subtrees found in it are not searched.
+	 * c is restored to its state at the call when the function returns.
+	 */
+	return search_completions(c,limit,NO_LIMIT,FALSE,NULL,NULL,token);
+}
+
+int count_completions_exact(candidates *c, bigint *total, cancel_token *token)
+{
 	/*
-	 * calculates the column index of the next cell in the backtracking algorithm.
-	 * returns i+1 if i<length, or 1 if i == length, assuming 1<=i<=length
+	 * Adds the number of ways to complete the grid in c to total, however many there are.
+	 * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+	 * A grid with EXACT_SPLIT_LIMIT completions or more is split on its most constrained cell and every digit
+	 * is counted on its own, so no count of count_completions can overflow. The searches of the split
+	 * aren't wasted when c has a transposition table: the subtrees counted before the split are in it.
+	 * Returns TRUE, or CANCELLED if token (may be NULL) was cancelled first (total is then only partly added).
+	 * c is restored to its state at the call when the function returns.
 	 */
-	return (i % length) + 1;
+	int count = count_completions(c,EXACT_SPLIT_LIMIT,token);
+	int mark = c->num_placed, cell, digit;
+	MASK legal;
+
+	if(count == CANCELLED)
+	{
+		return CANCELLED;
+	}
+	if(count < EXACT_SPLIT_LIMIT)
+	{
+		bigint_add_small(total,(unsigned long)count);
+		return TRUE;
+	}
+	cell = c->order[c->num_placed + most_constrained_cell(c,c->order+c->num_placed,c->num_empty-c->num_placed)];
+	legal = get_cell_candidates(c,cell);
+	while(legal != 0)
+	{
+		digit = lowest_digit(legal);
+		legal &= ~DIGIT_BIT(digit);
+		assign_digit(c,cell,digit);
+		if(propagate(c) && count_completions_exact(c,total,token) == CANCELLED)
+		{
+			undo_trail(c,mark);
+			return CANCELLED;
+		}
+		undo_trail(c,mark);
+	}
+	return TRUE;
 }
 
-int next_cell_j(int i, int j, int length) {
+static int luby(int i)
+{
 	/*
-	 * calculates the row index of the next cell in the backtracking algorithm.
-	 * returns j if i<length, or j+1 if i == length, assuming 1<=i<=length
+	 * Returns the i-th term (from 1) of the Luby sequence 1,1,2,1,1,2,4,1,1,2,1,1,2,4,8,...
 	 */
-	if (i == length) {
-		return j + 1;
+	int size = 1, power = 1; /*size = 2^k-1 is the length of the first block ending with power = 2^(k-1)*/
+	while(size < i)
+	{
+		size = 2*size + 1;
+		power *= 2;
 	}
-	return j;
+	while(size != i)
+	{/*i is in the second copy of the block before the size one*/
+		size /= 2;
+		power /= 2;
+		if(i > size)
+		{
+			i -= size;
+		}
+	}
+	return power;
 }
 
-void remove_at_index(int *values, int k) {
+BOOL find_completion(candidates *c, cancel_token *token)
+{
 	/*
-	 * virtually removes the k-th value of values. example: values = [5,1,3,5,6,9], k = 3 then values become [4,1,3,6,9(,9)]. "5" was the k-th value, and t
+	 * Searches for one way to complete the grid in c, with the same search as count_completions.
+	 * The search is restarted with the empty cells shuffled whenever it uses up its search nodes.
+	 * The i-th search gets luby(i) times RESTART_NODES_PER_CELL nodes per empty cell, so most searches are short
+	 * and a search that got stuck under a bad early choice (which happens on big boards) is abandoned soon,
+	 * while the long searches that hard grids need still come, every time at twice the length of the last one.
+	 * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+	 * Returns TRUE and leaves c filled with the completion if one exists (undo_trail can clear it),
+	 * returns FALSE or CANCELLED (if token was cancelled first) and leaves c unchanged otherwise.
+	 * Uses rand() when the search is restarted.
 	 */
-	int i;
-	int n = values[0];
-	for (i = k; i < n; i++) {
-		values[i] = values[i + 1];
+	int unit = RESTART_NODES_PER_CELL*(c->num_empty - c->num_placed + 1);
+	int result, restart = 1;
+	while(TRUE)
+	{
+		if(luby(restart) > INT_MAX/unit)
+		{/*the last search, to the end*/
+			result = search_completions(c,1,NO_LIMIT,TRUE,NULL,NULL,token);
+			break;
+		}
+		result = search_completions(c,1,luby(restart)*unit,TRUE,NULL,NULL,token);
+		if(result != OUT_OF_NODES)
+		{
+			break;
+		}
+		shuffle_trail(c);
+		restart++;
+	}
+	if(result == CANCELLED)
+	{
+		return CANCELLED;
 	}
-	values[0]--;
+	return result == 1;
 }
 
-int exhaustive_backtracking(sudoku_board *board) {
+int exhaustive_backtracking(sudoku_board *board, int limit, cancel_token *token)
+{
 	/*
 	 * Given an initialized sudoku board, counts and returns the amount of possible solutions for the board using exhaustive backtracking.
+	 * If limit is not NO_LIMIT, counting stops after limit solutions.
+	 * Returns CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+	 * See count_completions for the search itself, which memoizes subtree counts within the cap set with set_memo_size.
+	 * board->solution is left untouched.
 	 */
-	int length = board->length;
 	int num_solutions = 0;
-	int i, j, digit;
-	doublyLinkedList stack = NULL;
-	ijval *stack_node; /*the prev_val in ijval will represent the digit to be checked as a possible solution*/
-
-	/*initializing the "recursion"*/
-	stack_node = new_ijval(1, 1, 1, 0);/*the cell (1,1) is inserted the first legal value, then the rest of the board is checked*/
-	push(&stack, stack_node);
-	copy_matrix(board->cells, board->solution, length); /*making solution ready for solving*/
-
-	while (stack != NULL) /*as long as the stack is not empty*/
-	{
-		stack_node = (ijval*) (stack->data); /*peek top of the stack ("What do I need to check?")*/
-		digit = stack_node->prev_val;
-		i = stack_node->i;
-		j = stack_node->j;
-		/*printf("debug: i = %d, j = %d\n", i, j);debug*/
-
-		if (digit > length) {
-			board->solution[i - 1][j - 1] = 0;
-			free(pop(&stack)); /*remove exhausted option: "return" */
-			continue;
+	candidates *c = new_candidates(board);
+
+	c->memo = new_count_table(1);
+	/*a board with two neighbors of the same value or with an early contradiction has no solutions*/
+	if(load_candidates(c,board->cells))
+	{
+		start_trail(c);
+		if(propagate(c))
+		{
+			num_solutions = count_completions(c,limit,token);
+		}
+	}
+	free_candidates(c);
+	return num_solutions;
+}
+
+static MASK get_consistent_digits(candidates *c, int cell)
+{
+	/*
+	 * Returns the candidates of the empty cell of c that propagate doesn't refute when they are placed in it.
+	 * Assumes the trail of c was started. c is restored to its state at the call when the function returns.
+	 */
+	int mark = c->num_placed, digit;
+	MASK legal = get_cell_candidates(c,cell), consistent = 0;
+	while(legal != 0)
+	{
+		digit = lowest_digit(legal);
+		legal &= ~DIGIT_BIT(digit);
+		assign_digit(c,cell,digit);
+		if(propagate(c))
+		{
+			consistent |= DIGIT_BIT(digit);
+		}
+		undo_trail(c,mark);
+	}
+	return consistent;
+}
+
+static int pick_digit(MASK digits)
+{
+	/*
+	 * Returns one of the digits in digits (not 0), each with the same probability. Uses rand().
+	 */
+	int k;
+	for(k = get_index(count_digits(digits)); k > 1; k--)
+	{
+		digits &= digits - 1; /*drop the lowest digit*/
+	}
+	return lowest_digit(digits);
+}
+
+static int choose_by_counts(candidates *c, int cell, double *log_weight, cancel_token *token)
+{
+	/*
+	 * Chooses a digit of the empty cell of c with probability proportional to the number of solutions below it,
+	 * if the solutions below every digit can be counted within SAMPLE_COUNT_NODES search nodes,
+	 * and adds the log of the inverse of that probability to *log_weight.
+	 * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+	 * Uses rand(). Returns the digit, 0 if a count ran out of search nodes, or CANCELLED if token was cancelled first.
+	 * c is restored to its state at the call when the function returns.
+	 */
+	int counts[MAX_LENGTH+1];
+	int mark = c->num_placed, digit;
+	MASK legal = get_cell_candidates(c,cell);
+	double total = 0.0, r;
+
+	for(digit = 1; digit <= c->length; digit++)
+	{
+		counts[digit] = 0;
+		if(legal & DIGIT_BIT(digit))
+		{
+			assign_digit(c,cell,digit);
+			if(propagate(c))
+			{
+				counts[digit] = search_completions(c,NO_LIMIT,SAMPLE_COUNT_NODES,FALSE,NULL,NULL,token);
+			}
+			undo_trail(c,mark);
+			if(counts[digit] == CANCELLED || counts[digit] == OUT_OF_NODES)
+			{
+				return (counts[digit] == CANCELLED) ? CANCELLED : 0;
+			}
+			total += counts[digit];
+		}
+	}
+	if(total == 0.0)
+	{/*can't happen below a node with solutions, but the uniform step handles it*/
+		return 0;
+	}
+	r = rand()/(RAND_MAX + 1.0)*total;
+	for(digit = 1; digit < c->length && r >= counts[digit]; digit++)
+	{
+		r -= counts[digit];
+	}
+	while(counts[digit] == 0)
+	{/*rounding passed the last digit with solutions*/
+		digit--;
+	}
+	*log_weight += log(total/counts[digit]);
+	return digit;
+}
+
+static int propose_solution(candidates *c, int *solution, double *log_weight, BOOL *exact, cancel_token *token)
+{
+	/*
+	 * Draws a random solution of c for sample_solution and stores it in solution (indexed by cell).
+	 * Goes down the search tree one most constrained cell at a time, until the subtree it reached can be counted
+	 * within SAMPLE_COUNT_NODES search nodes and has fewer than SAMPLE_LIMIT solutions, and then takes one of those
+	 * uniformly. The digit of a cell is chosen by the counts of the solutions below its digits (see choose_by_counts)
+	 * when they can be counted, and uniformly among the consistent digits (see get_consistent_digits) otherwise.
+	 * So the solution is drawn with probability 1/weight, where weight is the product of the inverse probabilities
+	 * of the choices and of the count of the last subtree. Stores log(weight) in *log_weight, and stores in *exact
+	 * whether no digit was chosen uniformly, meaning every solution was equally likely.
+	 * After a count fails, the next one waits until an eighth of the empty cells left are filled,
+	 * so big, almost empty boards cost few counts.
+	 * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+	 * Uses rand(). Returns TRUE, FALSE if the path ended in a subtree without solutions,
+	 * or CANCELLED if token was cancelled first.
+	 * c is restored to its state at the call when the function returns.
+	 */
+	int mark = c->num_placed, next_count = c->num_empty, count = 0, cell, digit, left;
+	BOOL counted;
+	MASK consistent;
+
+	*log_weight = 0.0;
+	*exact = TRUE;
+	while(TRUE)
+	{
+		left = c->num_empty - c->num_placed;
+		counted = (left <= next_count);
+		if(counted)
+		{
+			count = search_completions(c,SAMPLE_LIMIT,SAMPLE_COUNT_NODES,FALSE,NULL,NULL,token);
+			if(count == CANCELLED || (count != OUT_OF_NODES && count < SAMPLE_LIMIT))
+			{
+				break;
+			}
+		}
+		cell = c->order[c->num_placed + most_constrained_cell(c,c->order+c->num_placed,left)];
+		digit = (counted && count == SAMPLE_LIMIT) ? choose_by_counts(c,cell,log_weight,token) : 0;
+		if(digit == CANCELLED)
+		{
+			count = CANCELLED;
+			break;
+		}
+		if(digit == 0)
+		{/*too many solutions to count, go down a random consistent digit*/
+			if(counted)
+			{
+				next_count = left - left/8 - 1;
+			}
+			consistent = get_consistent_digits(c,cell);
+			if(consistent == 0)
+			{/*the subtree has no solutions after all*/
+				count = 0;
+				break;
+			}
+			*log_weight += log((double)count_digits(consistent));
+			*exact = FALSE;
+			digit = pick_digit(consistent);
+		}
+		assign_digit(c,cell,digit);
+		propagate(c);
+	}
+
+	if(count > 0)
+	{/*the exact count is known: the k-th solution for a uniform k is left in c*/
+		*log_weight += log((double)count);
+		if(search_completions(c,get_index(count),NO_LIMIT,TRUE,NULL,NULL,token) == CANCELLED)
+		{
+			count = CANCELLED;
+		}
+		for(cell = 0; cell < c->num_cells; cell++)
+		{
+			solution[cell] = c->grid[cell];
+		}
+	}
+	undo_trail(c,mark);
+	if(count == CANCELLED)
+	{
+		return CANCELLED;
+	}
+	return count > 0;
+}
+
+BOOL sample_solution(sudoku_board *board, cancel_token *token)
+{
+	/*
+	 * Draws a random solution of the board and stores it in board->solution.
+	 * The draws of propose_solution are uniform as long as every digit on the way is chosen by exact counts,
+	 * which is the case on small boards and on boards with few solutions, and then the first draw is taken.
+	 * Otherwise a draw favors the solutions it reaches through few consistent digits, by a weight it knows,
+	 * and the bias is corrected with an independence Metropolis-Hastings chain of SAMPLE_PROPOSALS draws:
+	 * a draw replaces the current solution with probability min(1, its weight / the weight of the current one).
+	 * The chain tends to the uniform draw as it grows, and is already much closer to it than a single draw.
+	 * If no draw reaches a solution, which proves nothing, the solution is searched for with find_completion,
+	 * so a solvable board always gets one.
+	 * Uses rand(). assumes board is initialized.
+	 * returns TRUE/FALSE if the board is solvable/unsolvable, or CANCELLED if token (may be NULL) was cancelled first.
+	 * board->solution is left untouched unless TRUE is returned.
+	 */
+	int cell, k;
+	int *current, *proposal, *swap; /*solutions indexed by cell*/
+	double current_log_weight = 0.0, log_weight;
+	BOOL result = FALSE, proposed, exact = FALSE;
+	candidates *c = new_candidates(board);
+
+	c->memo = new_count_table(1);
+	current = (int*)malloc(c->num_cells*sizeof(int));
+	check_alloc(current,"sample_solution");
+	proposal = (int*)malloc(c->num_cells*sizeof(int));
+	check_alloc(proposal,"sample_solution");
+	/*a board with two neighbors of the same value or with an early contradiction has no solutions*/
+	if(load_candidates(c,board->cells))
+	{
+		start_trail(c);
+		if(propagate(c))
+		{
+			for(k = 0; k < SAMPLE_PROPOSALS && !exact && result != CANCELLED; k++)
+			{
+				proposed = propose_solution(c,proposal,&log_weight,&exact,token);
+				if(proposed == CANCELLED)
+				{
+					result = CANCELLED;
+				}
+				else if(proposed == TRUE
+						&& (result == FALSE || rand()/(RAND_MAX + 1.0) < exp(log_weight - current_log_weight)))
+				{
+					swap = current;
+					current = proposal;
+					proposal = swap;
+					current_log_weight = log_weight;
+					result = TRUE;
+				}
+			}
+			if(result == FALSE && !exact)
+			{/*every draw ran into a dead end, which proves nothing*/
+				result = find_completion(c,token);
+				for(cell = 0; cell < c->num_cells; cell++)
+				{
+					current[cell] = c->grid[cell];
+				}
+			}
+		}
+	}
+
+	if(result == TRUE)
+	{
+		for(cell = 0; cell < c->num_cells; cell++)
+		{
+			board->solution[c->column_of[cell]][c->row_of[cell]] = current[cell];
 		}
+	}
+	free(current);
+	free(proposal);
+	free_candidates(c);
+	return result;
+}
 
-		/*"else"*/
-		if (j > length) {
-			/*we reached the end without inserting an illegal value, new solution has been found!*/
-			num_solutions++;
+int count_solutions_exact(sudoku_board *board, bigint *total, cancel_token *token)
+{
+	/*
+	 * Counts the solutions of the board exactly, however many there are, and adds their number to total.
+	 * See count_completions_exact for the search, which memoizes subtree counts within the cap set with set_memo_size.
+	 * Returns TRUE, or CANCELLED if token (may be NULL) was cancelled or ran out of time first (total is then meaningless).
+	 * board->solution is left untouched.
+	 */
+	int result = TRUE;
+	candidates *c = new_candidates(board);
+
+	c->memo = new_count_table(1);
+	/*a board with two neighbors of the same value or with an early contradiction has no solutions*/
+	if(load_candidates(c,board->cells))
+	{
+		start_trail(c);
+		if(propagate(c))
+		{
+			result = count_completions_exact(c,total,token);
+		}
+	}
+	free_candidates(c);
+	return result;
+}
 
-			/*print_matrix(board->solution, length);debug*/
-			/*printf("\n");debug*/
+static double probe_solutions(candidates *c, double *exact_count, cancel_token *token)
+{
+	/*
+	 * Draws one random path down the search tree of c and returns Knuth's estimate of its number of solutions:
+	 * the product of the number of consistent digits of every cell branched on along the path, times the number
+	 * of solutions of the subtree the path ends in. The path ends as soon as that subtree can be counted exactly
+	 * within ESTIMATE_PROBE_NODES search nodes, and its exact count is stored in *exact_count.
+	 * Every digit of a cell is taken with the same probability, so the mean of many probes is the number of solutions.
+	 * Uses rand(). Returns CANCELLED if token was cancelled first.
+	 * c is restored to its state at the call when the function returns.
+	 */
+	int mark = c->num_placed, count, cell;
+	MASK consistent;
+	double weight = 1.0;
+
+	while((count = search_completions(c,NO_LIMIT,ESTIMATE_PROBE_NODES,FALSE,NULL,NULL,token)) == OUT_OF_NODES)
+	{/*too many solutions to count, go down a random consistent digit of the most constrained cell*/
+		cell = c->order[c->num_placed + most_constrained_cell(c,c->order+c->num_placed,c->num_empty-c->num_placed)];
+		consistent = get_consistent_digits(c,cell);
+		if(consistent == 0)
+		{/*the subtree has no solutions after all*/
+			count = 0;
+			break;
+		}
+		weight *= count_digits(consistent);
+		assign_digit(c,cell,pick_digit(consistent));
+		propagate(c);
+	}
+	undo_trail(c,mark);
+	if(count == CANCELLED)
+	{
+		return CANCELLED;
+	}
+	*exact_count = count;
+	return weight*count;
+}
 
-			/* "return" */
-			free(pop(&stack));
+BOOL estimate_solutions(sudoku_board *board, count_estimate *estimate, cancel_token *token)
+{
+	/*
+	 * Estimates the number of solutions of the board with random probes of its search tree (see probe_solutions),
+	 * drawn until token is cancelled or passes its deadline, or until MAX_ESTIMATE_PROBES probes were drawn.
+	 * The board is counted exactly instead if that takes fewer than ESTIMATE_EXACT_NODES search nodes.
+	 * The estimate is the mean of the probes, and its bounds are the 95% confidence interval of the mean
+	 * (with a normal approximation, so they are only as good as the variance of the probes is known).
+	 * The lower bound is never below the largest number of solutions a single probe counted exactly.
+	 * Uses rand(). The counts of the probes are memoized within the cap set with set_memo_size.
+	 * assumes board is initialized.
+	 * returns TRUE and fills estimate, FALSE if the board was counted exactly and has no solutions,
+	 * or CANCELLED if token was cancelled before the first probe ended.
+	 * board->solution is left untouched.
+	 */
+	int count = 0;
+	double probe, exact_count, delta, sum_squares = 0, margin;
+	BOOL result = FALSE;
+	candidates *c = new_candidates(board);
+
+	c->memo = new_count_table(1);
+	estimate->estimate = 0;
+	estimate->low = 0;
+	estimate->num_probes = 0;
+	estimate->exact = FALSE;
+	/*a board with two neighbors of the same value or with an early contradiction has no solutions*/
+	if(load_candidates(c,board->cells))
+	{
+		start_trail(c);
+		if(propagate(c))
+		{
+			count = search_completions(c,NO_LIMIT,ESTIMATE_EXACT_NODES,FALSE,NULL,NULL,token);
+		}
+	}
+	if(count == CANCELLED)
+	{
+		result = CANCELLED;
+	}
+	else if(count != OUT_OF_NODES)
+	{/*small enough to count*/
+		estimate->estimate = count;
+		estimate->low = count;
+		estimate->high = count;
+		estimate->exact = TRUE;
+		result = (count > 0) ? TRUE : FALSE;
+	}
+	else
+	{
+		while(estimate->num_probes < MAX_ESTIMATE_PROBES && (probe = probe_solutions(c,&exact_count,token)) != CANCELLED)
+		{/*Welford's running mean and sum of squared deviations*/
+			estimate->num_probes++;
+			delta = probe - estimate->estimate;
+			estimate->estimate += delta/estimate->num_probes;
+			sum_squares += delta*(probe - estimate->estimate);
+			if(exact_count > estimate->low)
+			{
+				estimate->low = exact_count;
+			}
+		}
+		if(estimate->num_probes == 0)
+		{
+			result = CANCELLED;
+		}
+		else
+		{
+			result = TRUE;
+			margin = (estimate->num_probes > 1) ? 1.96*sqrt(sum_squares/(estimate->num_probes - 1)/estimate->num_probes) : HUGE_VAL;
+			estimate->high = estimate->estimate + margin;
+			if(estimate->estimate - margin > estimate->low)
+			{
+				estimate->low = estimate->estimate - margin;
+			}
+		}
+	}
+	free_candidates(c);
+	return result;
+}
+
+int enumerate_solutions(sudoku_board *board, solution_visitor visit, void *data, cancel_token *token)
+{
+	/*
+	 * Calls visit with data on every solution of the board, in the order exhaustive_backtracking finds them.
+	 * Stops early if visit returns FALSE.
+	 * Returns the number of solutions visited, or CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+	 * board->solution is left untouched.
+	 */
+	int num_solutions = 0;
+	candidates *c = new_candidates(board);
+
+	if(load_candidates(c,board->cells))
+	{
+		start_trail(c);
+		if(propagate(c))
+		{
+			num_solutions = search_completions(c,NO_LIMIT,NO_LIMIT,FALSE,visit,data,token);
+		}
+	}
+	free_candidates(c);
+	return num_solutions;
+}
+
+/*
+ * A Dancing Links (Algorithm X) representation of the board as an exact cover problem.
+ * Every empty cell, and every (unit,digit) pair not already satisfied by the filled cells
+ * is a column that must be covered exactly once.
+ * Every legal (cell,digit) placement is a row covering the column of the cell and one column for each unit of the cell,
+ * four columns on a regular board.
+ * All the nodes live in one pool which is allocated once per board, and the links are indices into it.
+ * Node 0 is the root, nodes 1..num_columns are the column headers and the rest are the row nodes.
+ */
+typedef struct dlx_struct
+{
+	int num_columns;
+	int num_nodes;
+	int *left, *right, *up, *down; /*the links of each node*/
+	int *column; /*column[node] is the header of the node's column. For headers column[c]==c*/
+	int *size; /*size[c] is the number of nodes currently in column c (for headers only)*/
+	int *choice; /*choice[depth] is the row node chosen at that depth of the search*/
+}dlx;
+
+#define DLX_ROOT (0)
+
+static dlx* new_dlx(candidates *c)
+{
+	/*
+	 * Builds the exact cover matrix of the grid loaded in c.
+	 * Uses malloc, free it with free_dlx.
+	 */
+	int length = c->length;
+	int num_cells = c->num_cells;
+	int num_constraints = num_cells + c->num_units*length;
+	int *column_id; /*maps each of the num_constraints constraints to its header, or -1 if it is already satisfied.
+					 *The constraint of a cell is the cell, and of a unit and a digit num_cells + unit*length + digit-1*/
+	int num_row_nodes = 0, num_columns = 0;
+	int cell, digit, k, u, node, header, first, last;
+	MASK legal;
+	dlx *d = (dlx*)malloc(sizeof(dlx));
+	check_alloc(d,"new_dlx");
+
+	column_id = (int*)malloc(num_constraints*sizeof(int));
+	check_alloc(column_id,"new_dlx");
+	for(k = 0; k < num_constraints; k++)
+	{
+		column_id[k] = -1;
+	}
+
+	/*first pass: find the needed columns and the number of row nodes*/
+	for(cell = 0; cell < num_cells; cell++)
+	{
+		if(c->grid[cell] != 0)
+		{
+			continue;
+		}
+		legal = get_cell_candidates(c,cell);
+		num_row_nodes += count_digits(legal)*(1 + c->first_unit[cell+1] - c->first_unit[cell]);
+		column_id[cell] = 1; /*any value that is not -1 marks the column as needed*/
+		for(digit = 1; digit <= length; digit++)
+		{
+			if(legal & DIGIT_BIT(digit))
+			{
+				for(u = c->first_unit[cell]; u < c->first_unit[cell+1]; u++)
+				{
+					column_id[num_cells + c->units_of[u]*length + digit-1] = 1;
+				}
+			}
+		}
+	}
+	for(k = 0; k < num_constraints; k++)
+	{
+		if(column_id[k] != -1)
+		{
+			num_columns++;
+			column_id[k] = num_columns; /*headers are numbered from 1*/
+		}
+	}
+
+	d->num_columns = num_columns;
+	d->num_nodes = 1 + num_columns + num_row_nodes;
+	d->left = (int*)malloc(d->num_nodes*sizeof(int));
+	d->right = (int*)malloc(d->num_nodes*sizeof(int));
+	d->up = (int*)malloc(d->num_nodes*sizeof(int));
+	d->down = (int*)malloc(d->num_nodes*sizeof(int));
+	d->column = (int*)malloc(d->num_nodes*sizeof(int));
+	d->size = (int*)calloc(num_columns+1,sizeof(int));
+	d->choice = (int*)malloc((num_cells+1)*sizeof(int));
+	check_alloc(d->left,"new_dlx");
+	check_alloc(d->right,"new_dlx");
+	check_alloc(d->up,"new_dlx");
+	check_alloc(d->down,"new_dlx");
+	check_alloc(d->column,"new_dlx");
+	check_alloc(d->size,"new_dlx");
+	check_alloc(d->choice,"new_dlx");
+
+	/*the root and the headers form a circular list*/
+	for(header = 0; header <= num_columns; header++)
+	{
+		d->left[header] = (header == 0) ? num_columns : header-1;
+		d->right[header] = (header == num_columns) ? 0 : header+1;
+		d->up[header] = header;
+		d->down[header] = header;
+		d->column[header] = header;
+	}
+
+	/*second pass: a row of nodes for every legal placement*/
+	node = num_columns + 1;
+	for(cell = 0; cell < num_cells; cell++)
+	{
+		if(c->grid[cell] != 0)
+		{
 			continue;
 		}
+		legal = get_cell_candidates(c,cell);
+		for(digit = 1; digit <= length; digit++)
+		{
+			if(!(legal & DIGIT_BIT(digit)))
+			{
+				continue;
+			}
+			first = node;
+			last = node + c->first_unit[cell+1] - c->first_unit[cell];
+			for(k = c->first_unit[cell]-1; k < c->first_unit[cell+1]; k++, node++)
+			{/*k == first_unit[cell]-1 stands for the constraint of the cell*/
+				header = (node == first) ? column_id[cell] : column_id[num_cells + c->units_of[k]*length + digit-1];
+				/*insert at the bottom of the column*/
+				d->column[node] = header;
+				d->up[node] = d->up[header];
+				d->down[node] = header;
+				d->down[d->up[header]] = node;
+				d->up[header] = node;
+				d->size[header]++;
+				/*link the nodes of the row in a circle*/
+				d->left[node] = (node == first) ? last : node-1;
+				d->right[node] = (node == last) ? first : node+1;
+			}
+		}
+	}
+
+	free(column_id);
+	return d;
+}
+
+static void free_dlx(dlx *d)
+{
+	/*
+	 * Frees all memory of d.
+	 */
+	free(d->left);
+	free(d->right);
+	free(d->up);
+	free(d->down);
+	free(d->column);
+	free(d->size);
+	free(d->choice);
+	free(d);
+}
+
+static void dlx_cover(dlx *d, int header)
+{
+	/*
+	 * Removes the column header from the header list and every row that intersects it from the other columns.
+	 */
+	int i, j;
+	d->right[d->left[header]] = d->right[header];
+	d->left[d->right[header]] = d->left[header];
+	for(i = d->down[header]; i != header; i = d->down[i])
+	{
+		for(j = d->right[i]; j != i; j = d->right[j])
+		{
+			d->down[d->up[j]] = d->down[j];
+			d->up[d->down[j]] = d->up[j];
+			d->size[d->column[j]]--;
+		}
+	}
+}
 
-		/*"else"*/
+static void dlx_uncover(dlx *d, int header)
+{
+	/*
+	 * Exactly reverts dlx_cover(d,header). Must be called in the reverse order of the covers.
+	 */
+	int i, j;
+	for(i = d->up[header]; i != header; i = d->up[i])
+	{
+		for(j = d->left[i]; j != i; j = d->left[j])
+		{
+			d->size[d->column[j]]++;
+			d->down[d->up[j]] = j;
+			d->up[d->down[j]] = j;
+		}
+	}
+	d->right[d->left[header]] = header;
+	d->left[d->right[header]] = header;
+}
 
-		if (board->cells[i - 1][j - 1] == 0) {
-			if (is_legal(board, i, j, digit, TRUE)) {/*if this cell is empty on the playing board and the digit is a legal value*/
-				board->solution[i - 1][j - 1] = digit; /*trying to put digit at the (i,j) place*/
-				stack_node->prev_val++; /*we'll try the next digit next time*/
-				/*beginning the same process on the next cell. "the recursive call"*/
-				stack_node = new_ijval(next_cell_i(i, length),
-						next_cell_j(i, j, length), 1, 0);
-				push(&stack, stack_node);
-				continue;/*go to check the head again*/
-			} else {/*the cell is empty but the digit is not legal*/
-				stack_node->prev_val++;/*check the next digit next time*/
-				continue;/*go to check the head again*/
+static int dlx_choose_column(dlx *d)
+{
+	/*
+	 * Returns the uncovered column with the fewest rows. Assumes there is one.
+	 */
+	int header, best = d->right[DLX_ROOT];
+	for(header = d->right[best]; header != DLX_ROOT; header = d->right[header])
+	{
+		if(d->size[header] < d->size[best])
+		{
+			best = header;
+			if(d->size[best] <= 1)
+			{
+				break;
 			}
-		} else {/*if this cell contains a value on the playing board, we don't need to change it at all*/
-			free(pop(&stack));/*destroy this cell at the stack so we won't come back to it*/
-			/*begin the same process on the next cell. "the recursive call"*/
-			stack_node = new_ijval(next_cell_i(i, length),
-					next_cell_j(i, j, length), 1, 0);
-			push(&stack, stack_node);
-			continue;/*go to check the head again*/
 		}
 	}
+	return best;
+}
+
+static int dlx_search(dlx *d, int limit, cancel_token *token)
+{
+	/*
+	 * Runs Algorithm X over d and returns the number of exact covers.
+	 * If limit is not NO_LIMIT, the search stops as soon as limit exact covers were found and limit is returned.
+	 * limit NO_LIMIT stops at INT_MAX exact covers the same way, so the count never overflows.
+	 * Returns CANCELLED if token was cancelled before the search ended.
+	 * The recursion is kept in d->choice, so the search does not allocate memory.
+	 * d is restored to its original state when the function returns, unless it stopped at the limit or was cancelled.
+	 */
+	int num_solutions = 0;
+	int depth = 0;
+	int nodes = 0; /*the search nodes since the token was last checked*/
+	int header, row, j;
+	BOOL descend = TRUE; /*TRUE when entering a new depth, FALSE when coming back to try the next row*/
+
+	if(limit == NO_LIMIT)
+	{
+		limit = INT_MAX;
+	}
+	while(TRUE)
+	{
+		if(descend)
+		{
+			if(d->right[DLX_ROOT] == DLX_ROOT)
+			{/*every column is covered, new solution has been found!*/
+				num_solutions++;
+				if(num_solutions == limit)
+				{/*enough solutions were found*/
+					break;
+				}
+				descend = FALSE;
+				continue;
+			}
+			if(++nodes == CANCEL_CHECK_INTERVAL)
+			{
+				nodes = 0;
+				if(is_cancelled(token))
+				{/*d is freed by the caller, no need to uncover*/
+					num_solutions = CANCELLED;
+					break;
+				}
+			}
+			header = dlx_choose_column(d);
+			if(d->size[header] == 0)
+			{/*this column can't be covered: "return"*/
+				descend = FALSE;
+				continue;
+			}
+			dlx_cover(d,header);
+			d->choice[depth] = d->down[header];
+		}
+		else
+		{
+			if(depth == 0)
+			{/*the whole tree was searched*/
+				break;
+			}
+			depth--;
+			row = d->choice[depth];
+			for(j = d->left[row]; j != row; j = d->left[j])
+			{/*undo the row that was tried last time*/
+				dlx_uncover(d,d->column[j]);
+			}
+			d->choice[depth] = d->down[row];
+		}
+
+		row = d->choice[depth];
+		header = d->column[row];
+		if(row == header)
+		{/*all the rows of this column were tried: "return"*/
+			dlx_uncover(d,header);
+			descend = FALSE;
+			continue;
+		}
+		for(j = d->right[row]; j != row; j = d->right[j])
+		{
+			dlx_cover(d,d->column[j]);
+		}
+		/*"the recursive call"*/
+		depth++;
+		descend = TRUE;
+	}
 	return num_solutions;
 }
 
+int dlx_count_solutions(sudoku_board *board, int limit, cancel_token *token)
+{
+	/*
+	 * Given an initialized sudoku board, counts and returns the amount of possible solutions for the board
+	 * by solving it as an exact cover problem with Dancing Links.
+	 * If limit is not NO_LIMIT, counting stops after limit solutions.
+	 * Returns CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+	 * board->solution is not changed.
+	 * The sum of a cage is not an exact cover constraint, so a board with cages is counted by exhaustive_backtracking.
+	 */
+	int num_solutions;
+	dlx *d;
+	candidates *c;
+
+	if(board->cages != NULL)
+	{
+		return exhaustive_backtracking(board,limit,token);
+	}
+	c = new_candidates(board);
+	if(!load_candidates(c,board->cells))
+	{/*two neighbors with the same value, nothing to count*/
+		free_candidates(c);
+		return 0;
+	}
+	d = new_dlx(c);
+	num_solutions = dlx_search(d,limit,token);
+	free_dlx(d);
+	free_candidates(c);
+	return num_solutions;
+}
+
+int count_solutions_bounded(sudoku_board *board, int limit, cancel_token *token)
+{
+	/*
+	 * Counts the possible solutions for the board with the active solver backend,
+	 * but stops as soon as limit solutions were found.
+	 * Returns the amount of solutions if it is smaller than limit, and limit otherwise.
+	 * limit NO_LIMIT counts all the solutions, up to INT_MAX: the count stops there instead of overflowing.
+	 * Returns CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+	 */
+	return backend_count(board,limit,token);
+}
+
+int count_solutions(sudoku_board *board)
+{
+	/*
+	 * Counts and returns the amount of possible solutions for the board
+	 * with the active solver backend (parallel backtracking by default).
+	 */
+	return count_solutions_bounded(board,NO_LIMIT,NULL);
+}
+
+BOOL has_unique_solution(sudoku_board *board)
+{
+	/*
+	 * Returns TRUE if the board has exactly one solution, FALSE if it has none or more than one.
+	 * Stops the search at the second solution, so it is much faster than counting all of them.
+	 */
+	return count_solutions_bounded(board,2,NULL) == 1;
+}
+
 int get_3d_index(int i, int j, int k, int length)
 {
 	/*
@@ -160,32 +1107,30 @@ int get_3d_index(int i, int j, int k, int length)
 	return i + j*length + k*length*length;
 }
 
-int create_gurobi_conversion(sudoku_board *board)
+static int create_gurobi_conversion(sudoku_board *board, int *ijk_to_gurobi)
 {
 	/*
 	 * Goes over all of board's cells and finds the gurobi xijk variables that are legal.
-	 * Inserts the data to the conversion "matrix" 'ijk_to_gurobi' and to the inverse
-	 * conversion 'gurobi_to_ijk'.
+	 * Fills the conversion "matrix" ijk_to_gurobi, an array of length^3 ints allocated by the caller:
+	 * ijk_to_gurobi[get_3d_index(i,j,k,length)] is the index of the gurobi variable of value k in cell <i,j>,
+	 * or -1 if there is no such variable.
 	 *
-	 * Returns the amount of gurobi variables found.
-	 * If there is an empty cell with no legal values, all resources are freed and the function returns -1.
+	 * A value is legal if no neighbor has it and it still fits the sum of the cage of the cell, if there is one.
 	 *
-	 * Remember to free (and NULLify) ijk_to_gurobi and gurobi_to_ijk before using.
+	 * Returns the amount of gurobi variables found.
+	 * If there is an empty cell with no legal values, the function returns -1.
 	 */
 	int i,j,k;
 	int length;
 	int legal_var_amount = 0;
 	int linear_index;
+	int cage;
+	MASK cage_digits;
 
 	BOOL legal_value_exists;
 
-	/*LINKEDLIST pos;*/ /*DEBUG*/
-
 	length = board->length;
 
-	ijk_to_gurobi = malloc(length*length*length*sizeof(int)); /*initialize ijk_to_gurobi*/
-	check_alloc(ijk_to_gurobi,"create_gurobi_conversion");
-
 	/*goes over the cells of the board to find legal values*/
 	for(j = 1; j <= length; j++)
 	{
@@ -194,19 +1139,21 @@ int create_gurobi_conversion(sudoku_board *board)
 			if( get(board,i,j) == 0 ) /*empty cell, need to find legal values for the cell*/
 			{
 				legal_value_exists = FALSE;
+				cage_digits = ~(MASK)0;
+				if(board->cages != NULL && (cage = board->cages->cage_of[(i-1)+(j-1)*length]) != -1)
+				{
+					cage_digits = get_cage_digits(board->cages,cage,get_cage_placed(board->cages,cage,board->cells));
+				}
 
 				for(k = 1 ; k <= length; k++)
 				{
 					linear_index = get_3d_index(i,j,k,length); /*target ijk index*/
 
-					if(is_legal(board,i,j,k,FALSE)) /*we need a varible, update conversion tables*/
+					if(is_legal(board,i,j,k,FALSE) && (cage_digits & DIGIT_BIT(k))) /*we need a varible, update the conversion table*/
 					{
 						ijk_to_gurobi[linear_index] = legal_var_amount;
 						legal_var_amount++;
 						legal_value_exists = TRUE;
-						appendToLinkedList(&gurobi_to_ijk,linear_index);
-
-
 					}
 					else
 					{
@@ -220,9 +1167,6 @@ int create_gurobi_conversion(sudoku_board *board)
 					 * Cells with no legal values will not have variables and no constraint will be violated,
 					 * causing an unsolvable board to seem solvable to gurobi.
 					 */
-					free(ijk_to_gurobi);
-					destroyLinkedList(gurobi_to_ijk);
-					gurobi_to_ijk = NULL;
 					return -1;
 				}
 			}
@@ -236,21 +1180,6 @@ int create_gurobi_conversion(sudoku_board *board)
 		}
 	}
 
-	/*ONE GIANT DEBUG*/
-	/*i = 0;
-	for(pos = gurobi_to_ijk; pos!=NULL;pos = pos->next )
-	{
-		j = ijk_to_gurobi[pos->data];
-		printf("gurobi_index: %d; converted ijk index: %d; back again: %d\n", i,pos->data,j);
-		if(i!=j)
-		{
-			printf("OH NO!!\n");
-			break;
-		}
-
-		i++;
-	}*/
-
 	return legal_var_amount;
 }
 
@@ -277,11 +1206,12 @@ void make_constraint_name(char* begin, int num, int digit, char* constraint_name
 }
 
 /*
- * converts the variable values gurobi has given to a flattened 3d matrix of size length*length*lentgh.
+ * converts the variable values gurobi has given to a flattened 3d matrix of size length*length*lentgh,
+ * with the conversion made by create_gurobi_conversion.
  * non existent variables get -1.
  * stores the values in target, which is assumed to be allocated.
  */
-void gurobi_solution_to_array(const double* gurobi_sol, double* target, int length)
+static void gurobi_solution_to_array(const double* gurobi_sol, double* target, const int *ijk_to_gurobi, int length)
 {
 	int i,j,k;
 	int gurobi_index,ijk_index;
@@ -292,29 +1222,123 @@ void gurobi_solution_to_array(const double* gurobi_sol, double* target, int leng
 		{
 			for(k = 1; k <= length; k++)
 			{
-				ijk_index = get_3d_index(i,j,k,length);
-				gurobi_index = ijk_to_gurobi[ijk_index];
-
-				if(gurobi_index < 0) /*no variable, set to minus 1*/
+				ijk_index = get_3d_index(i,j,k,length);
+				gurobi_index = ijk_to_gurobi[ijk_index];
+
+				if(gurobi_index < 0) /*no variable, set to minus 1*/
+				{
+					target[ijk_index] = -1.0;
+				}
+				else /*there is a variable, put its value*/
+				{
+					target[ijk_index] = gurobi_sol[gurobi_index];
+				}
+
+			}
+		}
+	}
+}
+
+static int __stdcall gurobi_cancel_callback(CB_ARGS)
+{
+	/*
+	 * Called by Gurobi during the optimization. Stops the optimization if the cancel token usrdata was cancelled.
+	 */
+	(void)cbdata;
+	(void)where;
+	if(is_cancelled((cancel_token*)usrdata))
+	{
+		GRBterminate(model);
+	}
+	return 0;
+}
+
+static int add_cage_constraints(GRBmodel *model, sudoku_board *board, const int *ijk_to_gurobi)
+{
+	/*
+	 * Adds the constraints of the cages of board (if it has any) to model:
+	 * the values of the empty cells of a cage add up to its sum without the digits placed in it
+	 * (sum_cage sum_v v*x[i,j,v] = sum - placed), and each value is used at most once in the cage
+	 * (sum_cage x[i,j,v] <= 1). The values that fit no combination of a cage have no variables, see create_gurobi_conversion.
+	 * Returns the error code of Gurobi, 0 if there was none.
+	 * Terminates the program on a memory allocation error.
+	 */
+	char constraint_names[32];
+	cage_table *cages = board->cages;
+	int length = board->length;
+	int cage, k, i, j, v, count, placed_sum, gurobi_index, error = 0;
+	int *ind;
+	double *coef;
+
+	if(cages == NULL)
+	{
+		return 0;
+	}
+	ind = malloc(sizeof(int)*length*length); /*a cage has at most length cells with length values each*/
+	coef = malloc(sizeof(double)*length*length);
+	check_alloc(ind,"generic_LP_solve");
+	check_alloc(coef,"generic_LP_solve");
+	for(cage = 0; cage < cages->num_cages && !error; cage++)
+	{
+		/*the sum constraint*/
+		count = 0;
+		placed_sum = 0;
+		for(k = cages->first_cell[cage]; k < cages->first_cell[cage+1]; k++)
+		{
+			i = cages->cells[k]%length + 1;
+			j = cages->cells[k]/length + 1;
+			placed_sum += get(board,i,j);
+			for(v = 1; v <= length; v++)
+			{
+				gurobi_index = ijk_to_gurobi[get_3d_index(i,j,v,length)];
+				if(gurobi_index>=0)
 				{
-					target[ijk_index] = -1.0;
+					ind[count] = gurobi_index;
+					coef[count] = (double)v;
+					count++;
 				}
-				else /*there is a variable, put its value*/
+			}
+		}
+		if(count>0)
+		{
+			make_constraint_name("cage",cage,0,constraint_names);
+			error = GRBaddconstr(model, count, ind, coef, GRB_EQUAL, (double)(cages->sum[cage] - placed_sum), constraint_names);
+		}
+
+		/*the values of a cage are all different, also when its cells are not in one group*/
+		for(v = 1; v <= length && !error; v++)
+		{
+			count = 0;
+			for(k = cages->first_cell[cage]; k < cages->first_cell[cage+1]; k++)
+			{
+				gurobi_index = ijk_to_gurobi[get_3d_index(cages->cells[k]%length + 1,cages->cells[k]/length + 1,v,length)];
+				if(gurobi_index>=0)
 				{
-					target[ijk_index] = gurobi_sol[gurobi_index];
+					ind[count] = gurobi_index;
+					coef[count] = 1.0;
+					count++;
 				}
-
+			}
+			if(count>1)
+			{
+				make_constraint_name("cage",cage,v,constraint_names);
+				error = GRBaddconstr(model, count, ind, coef, GRB_LESS_EQUAL, 1.0, constraint_names);
 			}
 		}
 	}
+	free(ind);
+	free(coef);
+	return error;
 }
 
-BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
+BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol, cancel_token *token)
 {
 	/*
 	 * Uses Integer or non-Integer Linear Programming to solve the board, depends on isInt (TRUE is ILP).
 	 * Stores the solution as a flattened 3d matrix inside sol, which is assumed to be allocated.
 	 * returns TRUE if the board is solvable, FALSE if the board is unsolvable and ERROR if an error encountered.
+	 * returns CANCELLED if token (may be NULL) was cancelled or ran out of time before the optimization ended.
+	 * The Gurobi environment and model are freed on every path.
 	 */
 
 	/*
@@ -324,17 +1348,16 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 	 * 'v' is all the legal values of the cell <i,j> according to the given board.
 	 * The constraints are as follows:
 	 *  1. Each cell must take exactly one value (sum_v x[i,j,v] = 1)
-	 *  2. Each legal value is used exactly once per row (sum_i x[i,j,v] = 1)
-	 *  3. Each legal value is used exactly once per column (sum_j x[i,j,v] = 1)
-	 *  4. Each legal value is used exactly once per block (sum_block x[i,j,v] = 1)
+	 *  2. Each legal value is used exactly once per group (sum_group x[i,j,v] = 1). The groups are the rows,
+	 *     the columns, the regions and the extra groups of the variant (see groups.h)
+	 *  3. The values of each cage add up to its sum and are all different, see add_cage_constraints
 	 */
 	/*constraint names*/
 	char constraint_names[32];
 
 	int length = board->length;
 	int n; /*number of actual variables*/
-	int hor = board->block_horizontal;
-	int ver = board->block_vertical;
+	group_table *groups = board->groups;
 
 	GRBenv *env = NULL;
 	GRBmodel *model = NULL;
@@ -342,8 +1365,8 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 	int error = 0;
 
 	double *gurobi_sol; /*array for the solution. needs to be dynamically allocated because we don't know how many variables there are*/
-	int *ind; /*array of variable indices at constraints. needs to be dynamically allocated because we don't know how many variables there are*/
-	double *coef;/*array of variable coefficients at constraints. malloc blabla...*/
+	int *ind = NULL; /*array of variable indices at constraints. needs to be dynamically allocated because we don't know how many variables there are*/
+	double *coef = NULL;/*array of variable coefficients at constraints. malloc blabla...*/
 
 	double *obj = NULL; /*array containing the coefficients of all the variables in the objective function*/
 
@@ -353,19 +1376,24 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 
 	double *lb = NULL, *ub = NULL; /*lower bound and upper bound*/
 
+	double time_left = get_time_left(token);
+
 	char binary_or_continuous = isInt ? GRB_BINARY:GRB_CONTINUOUS;
 
 	/*loop indices*/
-	int i,j,k,I,J,count;
+	int i,j,k,g,cell,count;
 
 	int gurobi_index; /*for storing varables index*/
 
-	GRBERROR = FALSE;
+	/*this call's own conversion between ijk and the gurobi variables, so solves can run concurrently*/
+	int *ijk_to_gurobi = malloc(sizeof(int)*length*length*length);
+	check_alloc(ijk_to_gurobi,"generic_LP_solve");
 
-	n = create_gurobi_conversion(board); /*get the variables we need and their number*/
+	n = create_gurobi_conversion(board,ijk_to_gurobi); /*get the variables we need and their number*/
 
 	if(n == -1) /* i.e. there exists an empty cell with no legal value*/
 	{
+		free(ijk_to_gurobi);
 		return FALSE;
 	}
 
@@ -397,16 +1425,24 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 	if (error)
 	{
 		printf("ERROR %d GRBloadenv(): %s\n", error, GRBgeterrormsg(env));
-		GRBERROR = TRUE;
-		return ERROR;
+		goto END;
 	}
 
 	error = GRBsetintparam(env, GRB_INT_PAR_LOGTOCONSOLE, 0);
 	if (error)
 	{
 		printf("ERROR %d GRBsetintattr(): %s\n", error, GRBgeterrormsg(env));
-		GRBERROR = TRUE;
-		return ERROR;
+		goto END;
+	}
+
+	if (time_left != NO_DEADLINE)
+	{/*Gurobi stops by itself when the token's time budget runs out*/
+		error = GRBsetdblparam(env, GRB_DBL_PAR_TIMELIMIT, time_left);
+		if (error)
+		{
+			printf("ERROR %d GRBsetdblparam(): %s\n", error, GRBgeterrormsg(env));
+			goto END;
+		}
 	}
 
 	/* Create an empty model named "sudoku_model" */
@@ -414,8 +1450,17 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 	if (error)
 	{
 		printf("ERROR %d GRBnewmodel(): %s\n", error, GRBgeterrormsg(env));
-		GRBERROR = TRUE;
-		return ERROR;
+		goto END;
+	}
+
+	if (token != NULL)
+	{/*let the caller stop the optimization*/
+		error = GRBsetcallbackfunc(model, gurobi_cancel_callback, token);
+		if (error)
+		{
+			printf("ERROR %d GRBsetcallbackfunc(): %s\n", error, GRBgeterrormsg(env));
+			goto END;
+		}
 	}
 
 	/*sudoku constraints*/
@@ -429,65 +1474,15 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 	}
 	for(k = 1; k <= length; k++) /*each digit gets a constraint*/
 	{
-		/*column constraints*/
-		for(i = 1; i <= length; i++)
-		{
-			count = 0;
-			for(j = 1; j <= length; j++)
-			{
-				gurobi_index = ijk_to_gurobi[get_3d_index(i,j,k,length)];
-				if(gurobi_index>=0)
-				{
-					ind[count] = gurobi_index; /*the count variable in the constraint corresponds to the gurobi_index*/
-					count++;
-				}
-			}
-			if(count>0)
-			{
-				make_constraint_name("column",i,k,constraint_names);
-				error = GRBaddconstr(model, count, ind, coef, GRB_EQUAL, 1.0, constraint_names);
-			}
-			if(error) goto END;
-		}
-
-		/*block constraints*/
-		for(J = 0; J < hor; J++)
-		{
-			for(I = 0; I < ver; I++)
-			{
-				/*this is executed for each block*/
-				count = 0;
-
-				for(i = hor*I+1; i<=hor*(I+1); i++)
-				{
-					for(j = ver*J+1; j<=ver*(J+1); j++)
-					{
-						gurobi_index = ijk_to_gurobi[get_3d_index(i,j,k,length)];
-
-						if(gurobi_index >= 0)
-						{
-							ind[count] = gurobi_index; /*the count variable in the constraint corresponds to the gurobi_index*/
-							count++;
-						}
-					}
-				}
-				if(count>0)
-				{
-					make_constraint_name("block", I+J*ver, k, constraint_names);
-					error = GRBaddconstr(model, count, ind, coef, GRB_EQUAL, 1.0, constraint_names);
-					if(error) goto END;
-				}
-			}
-		}
-
-		/*row constraints*/
-		for(j = 1; j <= length; j++)
+		/*group constraints: the rows, the columns, the regions and the extra groups of the variant*/
+		for(g = 0; g < groups->num_groups; g++)
 		{
 			count = 0;
-			for(i = 1; i <= length; i++)
+			for(cell = 0; cell < length; cell++)
 			{
+				i = groups->cells[g*length + cell]%length + 1;
+				j = groups->cells[g*length + cell]/length + 1;
 				gurobi_index = ijk_to_gurobi[get_3d_index(i,j,k,length)];
-
 				if(gurobi_index>=0)
 				{
 					ind[count] = gurobi_index; /*the count variable in the constraint corresponds to the gurobi_index*/
@@ -496,7 +1491,7 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 			}
 			if(count>0)
 			{
-				make_constraint_name("row",j,k,constraint_names);
+				make_constraint_name("group",g,k,constraint_names);
 				error = GRBaddconstr(model, count, ind, coef, GRB_EQUAL, 1.0, constraint_names);
 				if(error) goto END;
 			}
@@ -529,6 +1524,9 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 
 	}
 
+	error = add_cage_constraints(model, board, ijk_to_gurobi);
+	if(error) goto END;
+
 	error = GRBoptimize(model); /*the actual optimization happens here!*/
 	if (error) goto END;
 	error = GRBgetintattr(model, "status", &optimstatus);
@@ -542,14 +1540,18 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 	free(ind);
 	free(lb);
 	free(ub);
-	destroyLinkedList(gurobi_to_ijk);
-	gurobi_to_ijk = NULL;
 
 	if(error)
 	{
-		GRBfreemodel(model);
-		GRBfreeenv(env);
-		GRBERROR = TRUE;
+		free(ijk_to_gurobi);
+		if(model != NULL)
+		{
+			GRBfreemodel(model);
+		}
+		if(env != NULL)
+		{
+			GRBfreeenv(env);
+		}
 		return ERROR;
 	}
 
@@ -559,7 +1561,7 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 		check_alloc(gurobi_sol,"generic_LP_solve");
 
 		error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, n, gurobi_sol);
-		gurobi_solution_to_array(gurobi_sol,sol,length);
+		gurobi_solution_to_array(gurobi_sol,sol,ijk_to_gurobi,length);
 
 		free(gurobi_sol);
 		free(ijk_to_gurobi);
@@ -568,7 +1570,6 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 
 		if(error)
 		{
-			GRBERROR = TRUE;
 			return ERROR;
 		}
 		return TRUE;
@@ -583,21 +1584,26 @@ BOOL generic_LP_solve(sudoku_board *board, BOOL isInt, double* sol)
 		{
 			return FALSE;
 		}
+		else if(optimstatus == GRB_INTERRUPTED || optimstatus == GRB_TIME_LIMIT) /*the token stopped the optimization*/
+		{
+			return CANCELLED;
+		}
 		else /*optimization has stopped early*/
 		{
-			GRBERROR = ERROR;
 			return ERROR;
 		}
 	}
 
 }
 
-BOOL solve_board(sudoku_board *board)
+BOOL gurobi_solve_board(sudoku_board *board, cancel_token *token)
 {
 	/*
 	 * solves the board using ILP and stores the solution in board->solution.
 	 * assumes board is initialized.
-	 * returns TRUE/FALSE if the board is solvable/unsolvable or ERROR if such encountered.
+	 * returns TRUE/FALSE if the board is solvable/unsolvable or ERROR if such encountered,
+	 * or CANCELLED if token was cancelled first.
+	 * board->solution is left untouched unless TRUE is returned.
 	 */
 	BOOL isSolvable;
 
@@ -607,17 +1613,11 @@ BOOL solve_board(sudoku_board *board)
 
 	double* sol = malloc(sizeof(double)*length*length*length);
 	check_alloc(sol,"solve");
-	GRBERROR = FALSE;
-	isSolvable = generic_LP_solve(board,TRUE,sol);
-
-	copy_matrix(board->cells,board->solution,length);
+	isSolvable = generic_LP_solve(board,TRUE,sol,token);
 
-	if(isSolvable==ERROR)
-	{
-		GRBERROR = TRUE;
-	}
 	if(isSolvable==TRUE)
 	{
+		copy_matrix(board->cells,board->solution,length);
 		for(j = 1; j <= length; j++)
 		{
 			for(i = 1; i <= length; i++)
@@ -641,42 +1641,408 @@ BOOL solve_board(sudoku_board *board)
 	return isSolvable;
 }
 
-double* get_LP_scores(sudoku_board *board)
+BOOL native_solve_board(sudoku_board *board, cancel_token *token)
+{
+	/*
+	 * solves the board with the backtracking search of exhaustive_backtracking, stopped at the first solution,
+	 * and stores the solution in board->solution.
+	 * assumes board is initialized.
+	 * returns TRUE/FALSE if the board is solvable/unsolvable, like solve_board, or CANCELLED if token was cancelled first.
+	 * board->solution is left untouched unless TRUE is returned.
+	 */
+	int cell;
+	BOOL isSolvable = FALSE;
+	candidates *c = new_candidates(board);
+
+	/*a board with two neighbors of the same value or with an early contradiction is unsolvable*/
+	if(load_candidates(c,board->cells))
+	{
+		start_trail(c);
+		if(propagate(c))
+		{
+			isSolvable = find_completion(c,token);
+		}
+	}
+	if(isSolvable==TRUE)
+	{
+		for(cell = 0; cell < c->num_cells; cell++)
+		{
+			board->solution[c->column_of[cell]][c->row_of[cell]] = c->grid[cell];
+		}
+	}
+	free_candidates(c);
+	return isSolvable;
+}
+
+static void add_exactly_one(sat_solver *s, int *vars, int num_vars)
+{
+	/*
+	 * Adds clauses saying that exactly one of the variables vars[0..num_vars-1] is true:
+	 * one clause for "at least one" and a clause for every pair for "at most one".
+	 */
+	int k, m;
+	int pair[2];
+	sat_add_clause(s,vars,num_vars);
+	for(k = 0; k < num_vars; k++)
+	{
+		for(m = k+1; m < num_vars; m++)
+		{
+			pair[0] = -vars[k];
+			pair[1] = -vars[m];
+			sat_add_clause(s,pair,2);
+		}
+	}
+}
+
+static int count_cage_selectors(candidates *c)
+{
+	/*
+	 * Returns the number of selector variables encode_cage needs for all the cages of c:
+	 * one for every combination of a cage with empty cells that contains the digits placed in it.
+	 */
+	cage_table *cages = c->cages;
+	int cage, k, count = 0;
+	for(cage = 0; cages != NULL && cage < cages->num_cages; cage++)
+	{
+		if(c->cage_allowed[cage] == 0)
+		{/*full, or no combination fits and the empty cells have no candidates anyway*/
+			continue;
+		}
+		for(k = cages->first_combination[cage]; k < cages->last_combination[cage]; k++)
+		{
+			count += ((cages->combinations[k] & c->cage_placed[cage]) == c->cage_placed[cage]);
+		}
+	}
+	return count;
+}
+
+static int encode_cage(sat_solver *s, candidates *c, int *var_of, int cage, int next_var, int *lits)
+{
+	/*
+	 * Adds the sum of cage to s: the empty cells of cage hold the digits of one of its combinations,
+	 * without the digits placed in it. Every combination that contains the placed digits gets a selector variable
+	 * (numbered from next_var), some selector is true, and a true selector puts each of its missing digits in some
+	 * empty cell of the cage. As many digits are missing as there are empty cells, so every cell gets one of them.
+	 * lits must have room for length+1 literals and for the number of combinations of cage.
+	 * Returns the variable after the last selector.
+	 */
+	cage_table *cages = c->cages;
+	int length = c->length;
+	int k, m, digit, num_selectors = 0, num_lits;
+	MASK placed = c->cage_placed[cage], missing;
+	int *selectors;
+
+	if(c->cage_allowed[cage] == 0)
+	{/*see count_cage_selectors*/
+		return next_var;
+	}
+	selectors = lits + length + 1; /*after the longest clause of a digit*/
+	for(k = cages->first_combination[cage]; k < cages->last_combination[cage]; k++)
+	{
+		if((cages->combinations[k] & placed) != placed)
+		{
+			continue;
+		}
+		selectors[num_selectors++] = next_var;
+		missing = cages->combinations[k] & ~placed;
+		for(digit = 1; digit <= length; digit++)
+		{
+			if(!(missing & DIGIT_BIT(digit)))
+			{
+				continue;
+			}
+			num_lits = 0;
+			lits[num_lits++] = -next_var;
+			for(m = cages->first_cell[cage]; m < cages->first_cell[cage+1]; m++)
+			{
+				if(var_of[cages->cells[m]*length + digit-1] != 0)
+				{
+					lits[num_lits++] = var_of[cages->cells[m]*length + digit-1];
+				}
+			}
+			sat_add_clause(s,lits,num_lits);
+		}
+		next_var++;
+	}
+	sat_add_clause(s,selectors,num_selectors);
+	return next_var;
+}
+
+static sat_solver* encode_board(candidates *c, int *var_of)
+{
+	/*
+	 * Returns a SAT solver for the board loaded in c.
+	 * The variables are the same as generic_LP_solve's: x[i,j,v] for every value v that is legal in the empty cell <i,j>.
+	 * Every empty cell and every value missing from a unit (a row, a column, a region or an extra group) gets an exactly-one constraint.
+	 * The cages get the selector variables of encode_cage after them.
+	 * Stores in var_of[cell*length+digit-1] the variable of the value digit in cell, or 0 if it is illegal there.
+	 * var_of is assumed to be allocated with num_cells*length zeros. Free the solver with free_sat_solver.
+	 */
+	int length = c->length;
+	int cell, digit, unit, k, num_vars = 0, num_lits, next_var, cage;
+	int max_combinations = (c->cages != NULL) ? c->cages->num_combinations : 0;
+	int *lits = (int*)malloc((length + 1 + max_combinations)*sizeof(int));
+	int *cells;
+	MASK legal, missing;
+	sat_solver *s;
+
+	check_alloc(lits,"encode_board");
+	for(cell = 0; cell < c->num_cells; cell++)
+	{
+		if(c->grid[cell] == 0)
+		{
+			legal = get_cell_candidates(c,cell);
+			for(digit = 1; digit <= length; digit++)
+			{
+				if(legal & DIGIT_BIT(digit))
+				{
+					var_of[cell*length + digit-1] = ++num_vars;
+				}
+			}
+		}
+	}
+
+	s = new_sat_solver(num_vars + count_cage_selectors(c));
+	for(cell = 0; cell < c->num_cells; cell++)
+	{/*every empty cell has exactly one value*/
+		if(c->grid[cell] == 0)
+		{
+			num_lits = 0;
+			for(digit = 1; digit <= length; digit++)
+			{
+				if(var_of[cell*length + digit-1] != 0)
+				{
+					lits[num_lits++] = var_of[cell*length + digit-1];
+				}
+			}
+			add_exactly_one(s,lits,num_lits);
+		}
+	}
+	for(unit = 0; unit < c->num_units; unit++)
+	{/*every value missing from a unit is in exactly one of its empty cells*/
+		cells = c->unit_cells + unit*length;
+		missing = c->all_digits;
+		for(k = 0; k < length; k++)
+		{
+			if(c->grid[cells[k]] != 0)
+			{
+				missing &= ~DIGIT_BIT(c->grid[cells[k]]);
+			}
+		}
+		for(digit = 1; digit <= length; digit++)
+		{
+			if(!(missing & DIGIT_BIT(digit)))
+			{
+				continue;
+			}
+			num_lits = 0;
+			for(k = 0; k < length; k++)
+			{
+				if(var_of[cells[k]*length + digit-1] != 0)
+				{
+					lits[num_lits++] = var_of[cells[k]*length + digit-1];
+				}
+			}
+			add_exactly_one(s,lits,num_lits);
+		}
+	}
+	next_var = num_vars + 1;
+	for(cage = 0; c->cages != NULL && cage < c->cages->num_cages; cage++)
+	{
+		next_var = encode_cage(s,c,var_of,cage,next_var,lits);
+	}
+	free(lits);
+	return s;
+}
+
+static int get_sat_digit(sat_solver *s, int *var_of, int length, int cell)
+{
+	/*
+	 * Returns the value of the empty cell in the assignment found by the last successful solve of s,
+	 * a solver made by encode_board with var_of.
+	 */
+	int digit;
+	for(digit = 1; digit < length; digit++)
+	{
+		if(var_of[cell*length + digit-1] != 0 && sat_value(s,var_of[cell*length + digit-1]))
+		{
+			break;
+		}
+	}
+	return digit; /*the last legal value if none of the others is true*/
+}
+
+BOOL sat_solve_board(sudoku_board *board, cancel_token *token)
+{
+	/*
+	 * solves the board with the CDCL SAT solver and stores the solution in board->solution.
+	 * The variables are the same as generic_LP_solve's: x[i,j,v] for every value v that is legal in the empty cell <i,j>.
+	 * Every empty cell and every value missing from a unit (a row, a column, a region or an extra group) gets an exactly-one constraint,
+	 * and the cages of a killer sudoku are encoded with selector variables, see encode_cage.
+	 * assumes board is initialized.
+	 * returns TRUE/FALSE if the board is solvable/unsolvable, like solve_board, or CANCELLED if token was cancelled first.
+	 * board->solution is left untouched unless TRUE is returned.
+	 */
+	int length = board->length;
+	int cell;
+	int *var_of; /*see encode_board*/
+	BOOL isSolvable;
+	sat_solver *s;
+	candidates *c = new_candidates(board);
+
+	if(!load_candidates(c,board->cells))
+	{/*two neighbors with the same value*/
+		free_candidates(c);
+		return FALSE;
+	}
+
+	var_of = (int*)calloc(c->num_cells*length,sizeof(int));
+	check_alloc(var_of,"sat_solve_board");
+	s = encode_board(c,var_of);
+	isSolvable = sat_solve(s,token);
+	if(isSolvable==TRUE)
+	{
+		copy_matrix(board->cells,board->solution,length);
+		for(cell = 0; cell < c->num_cells; cell++)
+		{
+			if(c->grid[cell] == 0)
+			{
+				board->solution[c->column_of[cell]][c->row_of[cell]] = get_sat_digit(s,var_of,length,cell);
+			}
+		}
+	}
+
+	free_sat_solver(s);
+	free(var_of);
+	free_candidates(c);
+	return isSolvable;
+}
+
+BOOL find_backbone(sudoku_board *board, int **forced, cancel_token *token)
+{
+	/*
+	 * Finds the backbone of the board: the empty cells that have the same value in every solution.
+	 * Stores that value in forced (a matrix indexed like board->cells) for each of these cells, 0 for the other
+	 * empty cells and the cell's value for the filled cells. Also stores one solution in board->solution.
+	 * All the cells are decided by one incremental SAT solver: after a first solution, each cell that may still be
+	 * forced is solved again under the assumption that it has another value. No solution proves that the cell
+	 * is forced, and a solution rules out every cell whose value differs in it.
+	 * assumes board is initialized.
+	 * returns TRUE/FALSE if the board is solvable/unsolvable, or CANCELLED if token was cancelled first.
+	 * board->solution is left untouched unless TRUE is returned.
+	 */
+	int length = board->length;
+	int cell, other, var, assumption;
+	int *var_of; /*see encode_board*/
+	int **first; /*the first solution, stored in board->solution once every cell is decided*/
+	BOOL result;
+	sat_solver *s;
+	candidates *c = new_candidates(board);
+
+	copy_matrix(board->cells,forced,length);
+	if(!load_candidates(c,board->cells))
+	{/*two neighbors with the same value*/
+		free_candidates(c);
+		return FALSE;
+	}
+
+	var_of = (int*)calloc(c->num_cells*length,sizeof(int));
+	check_alloc(var_of,"find_backbone");
+	s = encode_board(c,var_of);
+	first = make_matrix(length);
+	copy_matrix(board->cells,first,length);
+	result = sat_solve(s,token);
+	if(result==TRUE)
+	{/*every empty cell may be forced to its value in the first solution*/
+		for(cell = 0; cell < c->num_cells; cell++)
+		{
+			if(c->grid[cell] == 0)
+			{
+				first[c->column_of[cell]][c->row_of[cell]] = get_sat_digit(s,var_of,length,cell);
+				forced[c->column_of[cell]][c->row_of[cell]] = first[c->column_of[cell]][c->row_of[cell]];
+			}
+		}
+	}
+	for(cell = 0; cell < c->num_cells && result==TRUE; cell++)
+	{/*the cells before cell are decided*/
+		if(c->grid[cell] != 0 || forced[c->column_of[cell]][c->row_of[cell]] == 0)
+		{
+			continue;
+		}
+		var = var_of[cell*length + forced[c->column_of[cell]][c->row_of[cell]]-1];
+		assumption = -var;
+		switch(sat_solve_assuming(s,&assumption,1,token))
+		{
+		case FALSE: /*forced, which also helps the following solves*/
+			sat_add_clause(s,&var,1);
+			break;
+		case TRUE:
+			for(other = cell; other < c->num_cells; other++)
+			{
+				if(c->grid[other] == 0 && forced[c->column_of[other]][c->row_of[other]] != get_sat_digit(s,var_of,length,other))
+				{
+					forced[c->column_of[other]][c->row_of[other]] = 0;
+				}
+			}
+			break;
+		default:
+			result = CANCELLED;
+		}
+	}
+	if(result==TRUE)
+	{
+		copy_matrix(first,board->solution,length);
+	}
+
+	free_matrix(first,length);
+	free_sat_solver(s);
+	free(var_of);
+	free_candidates(c);
+	return result;
+}
+
+BOOL solve_board(sudoku_board *board, cancel_token *token)
+{
+	/*
+	 * solves the board with the active solver backend (the native solver by default)
+	 * and stores the solution in board->solution.
+	 * assumes board is initialized.
+	 * returns TRUE/FALSE if the board is solvable/unsolvable or ERROR if such encountered,
+	 * or CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+	 * board->solution is left untouched unless TRUE is returned.
+	 */
+	return backend_solve(board,token);
+}
+
+double* get_scores(sudoku_board *board, int *status, cancel_token *token)
+{
+	/*
+	 * Returns the scores of get_LP_scores, computed by the active solver backend
+	 * (by Gurobi if the backend has no LP of its own). Same contract as get_LP_scores.
+	 */
+	return backend_scores(board,status,token);
+}
+
+double* get_LP_scores(sudoku_board *board, int *status, cancel_token *token)
 {
 	/*
 	 * Returns a flattened 3d matrix containing the scores of each digit in each cell given by the LP solver on success.
-	 * If an error occurred or the board was strongly unsolvable, returns NULL instead.
-	 * Use get_error_status() to see if there was an error.
+	 * If an error occurred, the board was strongly unsolvable or token (may be NULL) was cancelled first, returns NULL instead.
+	 * Stores in *status what happened: TRUE on success, FALSE if the board is unsolvable, ERROR on a Gurobi error
+	 * (Gurobi printed the message) or CANCELLED.
 	 * To get the ijk element, please use get_3d_index(i,j,k) to get the appropriate index.
 	 * If an element of the array is negative, it means this variable represented an illegal value and did not have a variable.
 	 * This function uses malloc, remember to free its return value content afterward.
 	 */
 	int length = board->length;
-	BOOL LP_status;
 	double* sol = malloc(sizeof(double)*length*length*length);
 	check_alloc(sol,"get_LP_scores");
-	GRBERROR = FALSE;
-	LP_status = generic_LP_solve(board,FALSE,sol);
-	if(LP_status!=TRUE)
-	{/*board is unsolvable or error*/
+	*status = generic_LP_solve(board,FALSE,sol,token);
+	if(*status!=TRUE)
+	{/*board is unsolvable, error or cancelled*/
 		free(sol);
-		if(LP_status==ERROR)
-		{
-			GRBERROR = TRUE;
-		}
 		return NULL;
 	}
 	/*board is solvable*/
 	return sol;
 }
-
-
-BOOL get_error_status()
-{
-	/*
-	 * Returns TRUE if Gurobi encountered a problem in the recent LP or ILP execution.
-	 * FALSE otherwise.
-	 * Useful when the function that uses Gurobi doesn't return ERROR on error.
-	 */
-	return(GRBERROR);
-}
@@ -4,6 +4,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+#include <math.h>
 #include "main_aux.h"
 #include "definitions.h"
 #include "matrix.h"
@@ -11,30 +13,234 @@
 #include "msg_prints.h"
 #include "linked_list.h"
 #include "game.h"
+#include "candidates.h"
+#include "cages.h"
+#include "parallel.h"
+#include "backend.h"
+#include "sat.h"
+#include "cancel.h"
+#include "bigint.h"
 
 
 /*
- * This module solves the Sudoku board using exhaustive backtracking, LP or ILP.
+ * This module solves the Sudoku board using exhaustive backtracking, Dancing Links, SAT, LP or ILP.
  */
 
+/*
+ * solves the board with the active solver backend (the native solver by default)
+ * and stores the solution in board->solution.
+ * assumes board is initialized.
+ * returns TRUE/FALSE if the board is solvable/unsolvable or ERROR if such encountered,
+ * or CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+ * board->solution is left untouched unless TRUE is returned.
+ */
+BOOL solve_board(sudoku_board *board, cancel_token *token);
+
 /*
  * solves the board using ILP and stores the solution in board->solution.
  * assumes board is initialized.
- * returns TRUE/FALSE if the board is solvable/unsolvable or ERROR if such encountered.
+ * returns TRUE/FALSE if the board is solvable/unsolvable or ERROR if such encountered,
+ * or CANCELLED if token was cancelled first.
+ * Every call builds its own model and variable conversion, so solves of different boards can run at once.
+ * board->solution is left untouched unless TRUE is returned.
+ */
+BOOL gurobi_solve_board(sudoku_board *board, cancel_token *token);
+
+/*
+ * solves the board with the backtracking search of exhaustive_backtracking, stopped at the first solution,
+ * and stores the solution in board->solution.
+ * assumes board is initialized.
+ * returns TRUE/FALSE if the board is solvable/unsolvable, like solve_board, or CANCELLED if token was cancelled first.
+ * board->solution is left untouched unless TRUE is returned.
+ */
+BOOL native_solve_board(sudoku_board *board, cancel_token *token);
+
+/*
+ * solves the board with the CDCL SAT solver and stores the solution in board->solution.
+ * The variables are the same as generic_LP_solve's: x[i,j,v] for every value v that is legal in the empty cell <i,j>.
+ * assumes board is initialized.
+ * returns TRUE/FALSE if the board is solvable/unsolvable, like solve_board, or CANCELLED if token was cancelled first.
+ * board->solution is left untouched unless TRUE is returned.
+ */
+BOOL sat_solve_board(sudoku_board *board, cancel_token *token);
+
+/*
+ * Finds the backbone of the board: the empty cells that have the same value in every solution.
+ * Stores that value in forced (a matrix indexed like board->cells) for each of these cells, 0 for the other
+ * empty cells and the cell's value for the filled cells. Also stores one solution in board->solution.
+ * All the cells are decided by one incremental SAT solver, with assumptions instead of a new solve per cell.
+ * assumes board is initialized.
+ * returns TRUE/FALSE if the board is solvable/unsolvable, or CANCELLED if token was cancelled first.
+ * board->solution is left untouched unless TRUE is returned.
+ */
+BOOL find_backbone(sudoku_board *board, int **forced, cancel_token *token);
+
+/*
+ * sample_solution picks among the solutions of a subtree uniformly when the subtree has fewer than this many.
  */
-BOOL solve_board(sudoku_board *board);
+#define SAMPLE_LIMIT (256)
 
 /*
- * Gets an empty sudoku board and randomly generates a full board. Stores the result in board.solution.
- * Returns: TRUE if a solution found, FALSE if no solution exists.
- *
+ * sample_solution corrects the bias of its random descents with a chain of this many of them.
+ * Larger values make the sample closer to uniform on boards with many solutions, but take longer.
  */
-BOOL generate_full_board(sudoku_board *board);
+#define SAMPLE_PROPOSALS (16)
+
+/*
+ * Draws a random solution of the board and stores it in board->solution.
+ * The search descends one cell at a time, choosing each digit with probability proportional to the number
+ * of solutions below it while these can be counted quickly, and uniformly among the consistent digits otherwise.
+ * The draw is uniform when every choice was counted, and otherwise the descents are chained by independence
+ * Metropolis-Hastings (SAMPLE_PROPOSALS of them), which corrects most of their bias toward the solutions
+ * below the cells with few consistent digits.
+ * Uses rand(). assumes board is initialized.
+ * returns TRUE/FALSE if the board is solvable/unsolvable, or CANCELLED if token (may be NULL) was cancelled first.
+ * board->solution is left untouched unless TRUE is returned.
+ */
+BOOL sample_solution(sudoku_board *board, cancel_token *token);
 
 /*
  * Given an initialized sudoku board, counts and returns the amount of possible solutions for the board using exhaustive backtracking.
+ * If limit is not NO_LIMIT, counting stops after limit solutions. Without a limit it stops at INT_MAX solutions,
+ * use count_solutions_exact for boards with more.
+ * Returns CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+ * The search runs on bitmask candidates and a frame stack allocated with them, so it allocates no memory of its own.
+ * Subtree counts are memoized in a transposition table, which grows up to the cap set with set_memo_size as it fills.
+ * board->solution is not changed.
+ */
+int exhaustive_backtracking(sudoku_board *board, int limit, cancel_token *token);
+
+/*
+ * Counts the solutions of the board exactly, however many there are, and adds their number to total,
+ * with the search of count_completions_exact.
+ * Returns TRUE, or CANCELLED if token (may be NULL) was cancelled or ran out of time first (total is then meaningless).
+ * board->solution is not changed.
+ */
+int count_solutions_exact(sudoku_board *board, bigint *total, cancel_token *token);
+
+/*
+ * estimate_solutions counts the board exactly if that takes fewer than this many search nodes.
  */
-int exhaustive_backtracking(sudoku_board *board);
+#define ESTIMATE_EXACT_NODES (1 << 16)
+
+/*
+ * A probe of estimate_solutions stops at the first subtree it can count within this many search nodes.
+ * Larger values make every probe closer to the true count (less variance) but slower.
+ */
+#define ESTIMATE_PROBE_NODES (1024)
+
+/*
+ * estimate_solutions stops after this many probes even if its token has no deadline.
+ */
+#define MAX_ESTIMATE_PROBES (1 << 20)
+
+/*
+ * An estimate of the number of solutions of a board, see estimate_solutions.
+ */
+typedef struct count_estimate_struct
+{
+	double estimate; /*the mean of the probes, or the exact count*/
+	double low; /*the lower bound of the 95% confidence interval*/
+	double high; /*the upper bound of the 95% confidence interval, HUGE_VAL after a single probe*/
+	int num_probes; /*the probes that were averaged, 0 if the board was counted exactly*/
+	BOOL exact; /*TRUE if the board was counted exactly, then low and high are the count too*/
+}count_estimate;
+
+/*
+ * Estimates the number of solutions of a board that has too many of them to count, with Knuth's estimator:
+ * every probe goes down one random path of the search tree, multiplying the number of consistent digits of
+ * every cell on the way, until the subtree left is small enough to count exactly within ESTIMATE_PROBE_NODES nodes.
+ * Probes are drawn until token is cancelled or passes its deadline, so the deadline is the estimate's time budget,
+ * and the estimate is their mean with a 95% confidence interval.
+ * A board that can be counted within ESTIMATE_EXACT_NODES search nodes is counted exactly instead.
+ * Uses rand(). assumes board is initialized.
+ * returns TRUE and fills estimate, FALSE if the board was counted exactly and has no solutions,
+ * or CANCELLED if token was cancelled before the first probe ended.
+ * board->solution is not changed.
+ */
+BOOL estimate_solutions(sudoku_board *board, count_estimate *estimate, cancel_token *token);
+
+/*
+ * A function that enumerate_solutions calls on every solution, with the filled grid in c->grid
+ * and the data given to enumerate_solutions. Returns FALSE to stop the enumeration, TRUE to go on.
+ */
+typedef BOOL (*solution_visitor)(candidates *c, void *data);
+
+/*
+ * Calls visit with data on every solution of the board, in the order exhaustive_backtracking finds them.
+ * Stops early if visit returns FALSE.
+ * Returns the number of solutions visited, or CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+ * board->solution is left untouched.
+ */
+int enumerate_solutions(sudoku_board *board, solution_visitor visit, void *data, cancel_token *token);
+
+/*
+ * Counts and returns the number of ways to complete the grid in c using exhaustive backtracking.
+ * If limit is not NO_LIMIT, the search stops as soon as limit solutions were found and limit is returned.
+ * limit NO_LIMIT stops at INT_MAX solutions the same way, so the count never overflows.
+ * Returns CANCELLED if token (may be NULL) was cancelled before the search ended.
+ * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+ * Forced cells are filled at every node and the empty cell with the fewest candidates is branched on.
+ * If c->memo isn't NULL, the counts of searched subtrees are stored in it and subtrees found in it are not searched.
+ * c is restored to its state at the call when the function returns.
+ */
+int count_completions(candidates *c, int limit, cancel_token *token);
+
+/*
+ * count_completions_exact splits a grid with at least this many completions, so its counts never overflow.
+ */
+#define EXACT_SPLIT_LIMIT (1 << 24)
+
+/*
+ * Adds the number of ways to complete the grid in c to total, however many there are, with the search
+ * of count_completions: a grid with EXACT_SPLIT_LIMIT completions or more is split on a cell and every digit
+ * is counted on its own.
+ * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+ * Returns TRUE, or CANCELLED if token (may be NULL) was cancelled first (total is then only partly added).
+ * c is restored to its state at the call when the function returns.
+ */
+int count_completions_exact(candidates *c, bigint *total, cancel_token *token);
+
+/*
+ * Searches for one way to complete the grid in c, with the same search as count_completions.
+ * The search is restarted with the empty cells shuffled whenever it uses up its search nodes, and every
+ * restart gets twice the nodes of the one before, so a bad early choice on a big board can't stall it.
+ * Assumes the trail of c was started and that propagate(c) returned TRUE since the last placement.
+ * Returns TRUE and leaves c filled with the completion if one exists (undo_trail can clear it),
+ * returns FALSE or CANCELLED (if token was cancelled first) and leaves c unchanged otherwise.
+ * Uses rand() when the search is restarted.
+ */
+BOOL find_completion(candidates *c, cancel_token *token);
+
+/*
+ * Given an initialized sudoku board, counts and returns the amount of possible solutions for the board
+ * by solving it as an exact cover problem with Dancing Links.
+ * If limit is not NO_LIMIT, counting stops after limit solutions.
+ * Returns CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+ * board->solution is not changed.
+ */
+int dlx_count_solutions(sudoku_board *board, int limit, cancel_token *token);
+
+/*
+ * Counts and returns the amount of possible solutions for the board
+ * with the active solver backend (parallel backtracking by default).
+ */
+int count_solutions(sudoku_board *board);
+
+/*
+ * Counts the possible solutions for the board with the active solver backend,
+ * but stops as soon as limit solutions were found.
+ * Returns the amount of solutions if it is smaller than limit, and limit otherwise.
+ * limit NO_LIMIT counts all the solutions, up to INT_MAX: the count stops there instead of overflowing.
+ * Returns CANCELLED if token (may be NULL) was cancelled or ran out of time first.
+ */
+int count_solutions_bounded(sudoku_board *board, int limit, cancel_token *token);
+
+/*
+ * Returns TRUE if the board has exactly one solution, FALSE if it has none or more than one.
+ * Stops the search at the second solution, so it is much faster than counting all of them.
+ */
+BOOL has_unique_solution(sudoku_board *board);
 
 /*
  * gets the index of a 3d cubic matrix and converts it to a flattened version index.
@@ -46,17 +252,20 @@ int get_3d_index(int i, int j, int k, int length);
 
 /*
  * Returns a flattened 3d matrix containing the scores of each digit in each cell given by the LP solver on success.
- * If an error occurred or the board was strongly unsolvable, returns NULL instead.
+ * If an error occurred, the board was strongly unsolvable or token (may be NULL) was cancelled first, returns NULL instead.
+ * Stores in *status what happened: TRUE on success, FALSE if the board is unsolvable, ERROR on a Gurobi error
+ * (Gurobi printed the message) or CANCELLED.
+ * Keeps no state between calls, so it can run on several threads at once.
  * To get the ijk element, please use get_3d_index(i,j,k) to get the appropriate index.
  * If an element of the array is negative, it means this variable represented an illegal value and did not have a variable.
  * This function uses malloc, remember to free its return value content afterward.
  */
-double* get_LP_scores(sudoku_board *board);
+double* get_LP_scores(sudoku_board *board, int *status, cancel_token *token);
 
 /*
- * Returns TRUE if Gurobi encountered a problem in the recent LP or ILP execution.
- * FALSE otherwise.
- * Useful when the function that uses Gurobi doesn't return ERROR on error.
+ * Returns the scores of get_LP_scores, computed by the active solver backend
+ * (by Gurobi if the backend has no LP of its own). Same contract as get_LP_scores.
  */
-BOOL get_error_status();
+double* get_scores(sudoku_board *board, int *status, cancel_token *token);
+
 #endif /*__SOLVER_H__*/
@@ -0,0 +1,280 @@
+#include "symmetry.h"
+#include "candidates.h"
+#include "solver.h"
+#include "transposition.h"
+#include "main_aux.h"
+
+/*
+ * This module counts the solutions of boards with few givens by dividing out their symmetries.
+ * Two kinds of symmetries map the solutions of a board to other solutions without ever fixing one:
+ *  Relabelling the free digits, the digits that no given uses.
+ *  Permuting the empty lines (rows or columns) of a band among themselves, and permuting whole empty bands,
+ *  while one line, the fixed line, stays in place.
+ * The line permutations keep only the rows, the columns and the blocks, so boards of a variant are only relabelled.
+ * Rows are different in every column and columns are different in every row, so a line permutation
+ * always moves a solution, and so does a relabelling. So every orbit has the size of the group, and only
+ * one representative of every orbit is counted: the solution whose free digits appear in increasing order
+ * along the fixed line, and whose permuted lines are sorted by their first cell (and the empty bands by their
+ * first line). That is decided by a few cells, which are filled before the rest of the board is counted.
+ */
+
+/*
+ * The search for the representatives: the cells that decide if a solution is one, with their conditions.
+ */
+typedef struct orbit_search_struct
+{
+	candidates *c;
+	MASK free_digits; /*the digits that no given uses*/
+	int *cells; /*the cells filled first: the empty cells of the fixed line, then the first cell of every permuted line*/
+	int *above; /*above[k] is the index in cells of the cell whose digit the digit of cells[k] must exceed, or -1*/
+	int num_fixed; /*cells[0...num_fixed-1] are in the fixed line*/
+	int num_cells;
+	bigint *total; /*the representatives counted so far*/
+	cancel_token *token;
+}orbit_search;
+
+static int line_cell(candidates *c, BOOL by_columns, int line, int k)
+{
+	/*
+	 * Returns the k-th cell (from 0) of the line-th column if by_columns is TRUE, of the line-th row otherwise.
+	 */
+	return by_columns ? line + k*c->length : k + line*c->length;
+}
+
+static int count_empty_cells(candidates *c, BOOL by_columns, int line)
+{
+	/*
+	 * Returns the number of empty cells in the line-th column if by_columns is TRUE, in the line-th row otherwise.
+	 */
+	int k, count = 0;
+	for(k = 0; k < c->length; k++)
+	{
+		count += (c->grid[line_cell(c,by_columns,line,k)] == 0);
+	}
+	return count;
+}
+
+static int choose_fixed_line(candidates *c, BOOL by_columns)
+{
+	/*
+	 * Returns the column (if by_columns is TRUE) or row with the fewest empty cells,
+	 * which has the fewest ways to place the free digits in increasing order.
+	 */
+	int line, count, best = 0, best_count = c->length + 1;
+	for(line = 0; line < c->length; line++)
+	{
+		count = count_empty_cells(c,by_columns,line);
+		if(count < best_count)
+		{
+			best = line;
+			best_count = count;
+		}
+	}
+	return best;
+}
+
+static double count_line_permutations(candidates *c, BOOL by_columns, int per_band, int fixed_line)
+{
+	/*
+	 * Returns the number of permutations of the empty columns (if by_columns is TRUE) or rows that keep fixed_line
+	 * in place: every band's empty lines can be permuted, and so can the empty bands without fixed_line.
+	 * per_band is the number of lines in a band.
+	 */
+	int band, k, line, movable, empty_bands = 0;
+	double order = 1;
+	for(band = 0; band < c->length/per_band; band++)
+	{
+		movable = 0;
+		for(k = 0; k < per_band; k++)
+		{
+			line = band*per_band + k;
+			if(line != fixed_line && count_empty_cells(c,by_columns,line) == c->length)
+			{
+				order *= ++movable;
+			}
+		}
+		if(movable == per_band)
+		{
+			order *= ++empty_bands;
+		}
+	}
+	return order;
+}
+
+static void add_line_permutations(orbit_search *s, BOOL by_columns, int per_band, int fixed_line, bigint *symmetries)
+{
+	/*
+	 * Adds to s the first cell of every permuted line (see count_line_permutations), with the conditions
+	 * that sort every band's permuted lines and the empty bands by those cells,
+	 * and multiplies symmetries by the number of permutations.
+	 */
+	candidates *c = s->c;
+	int band, k, line, movable, empty_bands = 0;
+	int band_first, previous, last_band_first = -1; /*indices in s->cells*/
+	for(band = 0; band < c->length/per_band; band++)
+	{
+		movable = 0;
+		band_first = -1;
+		previous = -1;
+		for(k = 0; k < per_band; k++)
+		{
+			line = band*per_band + k;
+			if(line != fixed_line && count_empty_cells(c,by_columns,line) == c->length)
+			{
+				s->cells[s->num_cells] = line_cell(c,by_columns,line,0);
+				s->above[s->num_cells] = previous;
+				if(previous == -1)
+				{
+					band_first = s->num_cells;
+				}
+				previous = s->num_cells;
+				s->num_cells++;
+				bigint_multiply_small(symmetries,++movable);
+			}
+		}
+		if(movable == per_band)
+		{/*an empty band: its lines are sorted, so its first line is its smallest, and the bands are sorted by it*/
+			s->above[band_first] = last_band_first;
+			last_band_first = band_first;
+			bigint_multiply_small(symmetries,++empty_bands);
+		}
+	}
+}
+
+static int count_representatives(orbit_search *s, int k, MASK free_left)
+{
+	/*
+	 * Fills s->cells[k...] in every way that fits the conditions of a representative, and adds the completions
+	 * of every filling to s->total. free_left holds the free digits not yet placed in the fixed line.
+	 * Cells that propagation filled already are only checked.
+	 * Returns TRUE, or CANCELLED if the token was cancelled first.
+	 */
+	candidates *c = s->c;
+	int cell, digit, bound, mark = c->num_placed;
+	MASK legal, lowest_free = free_left & (~free_left + 1);
+
+	if(k == s->num_cells)
+	{
+		return count_completions_exact(c,s->total,s->token);
+	}
+	cell = s->cells[k];
+	legal = (c->grid[cell] != 0) ? DIGIT_BIT(c->grid[cell]) : get_cell_candidates(c,cell);
+	if(k < s->num_fixed)
+	{/*the free digits appear in increasing order along the fixed line, so only the smallest one left fits here*/
+		legal &= ~(s->free_digits & ~lowest_free);
+	}
+	if(s->above[k] != -1)
+	{/*only the digits above the bound*/
+		bound = c->grid[s->cells[s->above[k]]];
+		legal &= ~(DIGIT_BIT(bound) | (DIGIT_BIT(bound) - 1));
+	}
+	while(legal != 0)
+	{
+		digit = lowest_digit(legal);
+		legal &= ~DIGIT_BIT(digit);
+		if(c->grid[cell] == 0)
+		{
+			assign_digit(c,cell,digit);
+			if(!propagate(c))
+			{
+				undo_trail(c,mark);
+				continue;
+			}
+		}
+		if(count_representatives(s,k+1,free_left & ~DIGIT_BIT(digit)) == CANCELLED)
+		{
+			undo_trail(c,mark);
+			return CANCELLED;
+		}
+		undo_trail(c,mark);
+	}
+	return TRUE;
+}
+
+int count_solutions_symmetric(sudoku_board *board, bigint *total, bigint *symmetries, cancel_token *token)
+{
+	/*
+	 * Counts the solutions of the board exactly, counting one representative of every orbit of symmetric solutions
+	 * and multiplying by the size of the orbits. Adds the number of solutions to total, and multiplies symmetries
+	 * by the number of symmetries that were divided out (so they should hold 0 and 1 at the call).
+	 * Returns TRUE, or CANCELLED if token (may be NULL) was cancelled or ran out of time first
+	 * (total and symmetries are then meaningless).
+	 * board->solution is not changed.
+	 * Terminates the program on a memory allocation error.
+	 */
+	orbit_search s;
+	candidates *c = new_candidates(board);
+	int length = board->length;
+	int k, digit, fixed_line, result = TRUE;
+	int fixed_row, fixed_column;
+	BOOL by_columns;
+	MASK used = 0;
+	bigint *representatives = new_bigint(0);
+
+	c->memo = new_count_table(1);
+	s.c = c;
+	s.total = representatives;
+	s.token = token;
+	s.num_cells = 0;
+	s.cells = (int*)malloc(2*length*sizeof(int));
+	s.above = (int*)malloc(2*length*sizeof(int));
+	check_alloc(s.cells,"count_solutions_symmetric");
+	check_alloc(s.above,"count_solutions_symmetric");
+
+	/*a board with two neighbors of the same value has no solutions*/
+	if(load_candidates(c,board->cells))
+	{
+		for(k = 0; k < length; k++)
+		{
+			used |= c->unit_used[k];
+		}
+		s.free_digits = c->all_digits & ~used;
+		if(board->cages != NULL)
+		{/*the sums of the cages tell the digits apart*/
+			s.free_digits = 0;
+		}
+
+		/*the rows or the columns, whichever can be permuted in more ways*/
+		fixed_row = choose_fixed_line(c,FALSE);
+		fixed_column = choose_fixed_line(c,TRUE);
+		by_columns = count_line_permutations(c,TRUE,board->block_horizontal,fixed_column)
+				> count_line_permutations(c,FALSE,board->block_vertical,fixed_row);
+		fixed_line = by_columns ? fixed_column : fixed_row;
+
+		if(s.free_digits != 0)
+		{
+			for(k = 0; k < length; k++)
+			{
+				if(c->grid[line_cell(c,by_columns,fixed_line,k)] == 0)
+				{
+					s.cells[s.num_cells] = line_cell(c,by_columns,fixed_line,k);
+					s.above[s.num_cells] = -1;
+					s.num_cells++;
+				}
+			}
+			for(digit = 1; digit <= count_digits(s.free_digits); digit++)
+			{
+				bigint_multiply_small(symmetries,digit);
+			}
+		}
+		s.num_fixed = s.num_cells;
+		if(board->groups->standard && board->cages == NULL)
+		{/*a jigsaw piece, an extra group or a cage isn't kept by moving lines around*/
+			add_line_permutations(&s,by_columns,by_columns ? board->block_horizontal : board->block_vertical,fixed_line,symmetries);
+		}
+
+		start_trail(c);
+		if(propagate(c))
+		{
+			result = count_representatives(&s,0,s.free_digits);
+		}
+	}
+	bigint_multiply(representatives,symmetries);
+	bigint_add(total,representatives);
+
+	free_bigint(representatives);
+	free(s.cells);
+	free(s.above);
+	free_candidates(c);
+	return result;
+}
@@ -0,0 +1,32 @@
+#ifndef SYMMETRY_H_
+#define SYMMETRY_H_
+
+#include "definitions.h"
+#include "bigint.h"
+#include "cancel.h"
+
+/*
+ * This module counts the solutions of boards with few givens by dividing out their symmetries.
+ * Two kinds of symmetries map the solutions of a board to other solutions without ever fixing one:
+ *  Relabelling the free digits, the digits that no given uses.
+ *  Permuting the empty lines (rows or columns) of a band among themselves, and permuting whole empty bands,
+ *  while one line, the fixed line, stays in place.
+ * So every orbit of solutions under these symmetries has the same size, the size of the group, and it is
+ * enough to count one representative of every orbit: the solution whose free digits appear in increasing order
+ * along the fixed line, and whose permuted lines are sorted by their first cell.
+ * Permutations of rows and of columns together can fix a solution, so only one of them is used:
+ * the lines that give the larger group.
+ */
+
+/*
+ * Counts the solutions of the board exactly, counting one representative of every orbit of symmetric solutions
+ * and multiplying by the size of the orbits. Adds the number of solutions to total, and multiplies symmetries
+ * by the number of symmetries that were divided out (so they should hold 0 and 1 at the call).
+ * Returns TRUE, or CANCELLED if token (may be NULL) was cancelled or ran out of time first
+ * (total and symmetries are then meaningless).
+ * board->solution is not changed.
+ * Terminates the program on a memory allocation error.
+ */
+int count_solutions_symmetric(sudoku_board *board, bigint *total, bigint *symmetries, cancel_token *token);
+
+#endif /* SYMMETRY_H_ */
@@ -0,0 +1,223 @@
+#include <limits.h>
+#include "transposition.h"
+#include "main_aux.h"
+
+/*
+ * This module is the transposition table of the solution counter: a fixed size hash table that
+ * remembers how many solutions a subtree of the search has, keyed by the hash of the remaining
+ * constraints at its root (see candidates.h). A subtree that is reached again is counted once.
+ * The table starts small and doubles as it fills, up to its memory cap, so a short count doesn't pay
+ * for a big table. When the table is full, the entry that took the least search to count is evicted first.
+ */
+
+/*
+ * The number of entries a key can go to. The table is an array of buckets of this size.
+ */
+#define BUCKET_SIZE (4)
+
+/*
+ * A table starts with this many buckets. A cap that doesn't allow that many isn't worth the lookups,
+ * so no table is made for it.
+ */
+#define MIN_BUCKETS (64)
+
+/*
+ * The memory cap of the tables of one count, in megabytes. 0 means no memoization.
+ */
+static int memo_megabytes = DEFAULT_MEMO_MEGABYTES;
+
+typedef struct table_entry_struct
+{
+	unsigned long key[KEY_WORDS];
+	int count; /*the number of solutions of the subtree*/
+	int work; /*one more than the search nodes it took to count them, 0 if the entry is empty*/
+}table_entry;
+
+struct transposition_table_struct
+{
+	table_entry *entries; /*bucket b is entries[b*BUCKET_SIZE...(b+1)*BUCKET_SIZE-1]*/
+	unsigned long bucket_mask; /*the number of buckets (a power of 2) minus 1*/
+	unsigned long max_buckets; /*the most buckets the memory cap allows*/
+	unsigned long num_used; /*the entries that aren't empty*/
+};
+
+void set_memo_size(int megabytes)
+{
+	/*
+	 * Sets the memory cap, in megabytes, of all the transposition tables of one count together.
+	 * 0 turns memoization off.
+	 */
+	memo_megabytes = megabytes;
+}
+
+int get_memo_size()
+{
+	/*
+	 * Returns the memory cap, in megabytes, set with set_memo_size.
+	 */
+	return memo_megabytes;
+}
+
+transposition_table* new_transposition_table(size_t max_bytes)
+{
+	/*
+	 * Allocates an empty transposition table that grows to at most max_bytes bytes.
+	 * Returns NULL if max_bytes is too small for a useful table (so memoization is off).
+	 * Uses malloc, free it with free_transposition_table.
+	 * Terminates the program on a memory allocation error.
+	 */
+	transposition_table *table;
+	size_t bucket_bytes = BUCKET_SIZE*sizeof(table_entry);
+
+	if(max_bytes / bucket_bytes < MIN_BUCKETS)
+	{
+		return NULL;
+	}
+	table = (transposition_table*)malloc(sizeof(transposition_table));
+	check_alloc(table,"new_transposition_table");
+	table->max_buckets = MIN_BUCKETS;
+	while(table->max_buckets*2 <= max_bytes / bucket_bytes)
+	{
+		table->max_buckets *= 2;
+	}
+	/*calloc empties every entry (work 0)*/
+	table->entries = (table_entry*)calloc(MIN_BUCKETS*BUCKET_SIZE,sizeof(table_entry));
+	check_alloc(table->entries,"new_transposition_table");
+	table->bucket_mask = MIN_BUCKETS - 1;
+	table->num_used = 0;
+	return table;
+}
+
+transposition_table* new_count_table(int num_tables)
+{
+	/*
+	 * Allocates the transposition table of one of num_tables threads that count together: an empty table
+	 * with an equal share of the memory cap set with set_memo_size.
+	 * Returns NULL if memoization is off or the share is too small for a useful table.
+	 * Uses malloc, free it with free_transposition_table.
+	 * Terminates the program on a memory allocation error.
+	 */
+	size_t max_bytes = ((size_t)memo_megabytes << 20) / num_tables;
+	return new_transposition_table(max_bytes);
+}
+
+void free_transposition_table(transposition_table *table)
+{
+	/*
+	 * Frees all memory of table. table may be NULL.
+	 */
+	if(table!=NULL)
+	{
+		free(table->entries);
+		free(table);
+	}
+}
+
+static BOOL same_key(table_entry *entry, unsigned long *key)
+{
+	/*
+	 * Returns TRUE if entry holds key, FALSE otherwise.
+	 */
+	int k;
+	for(k = 0; k < KEY_WORDS; k++)
+	{
+		if(entry->key[k] != key[k])
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+BOOL lookup_count(transposition_table *table, unsigned long *key, int *count)
+{
+	/*
+	 * Looks up the subtree with the given key.
+	 * Returns TRUE and stores its number of solutions in *count if it is in table, FALSE otherwise.
+	 */
+	table_entry *bucket = table->entries + (key[0] & table->bucket_mask)*BUCKET_SIZE;
+	int k;
+	for(k = 0; k < BUCKET_SIZE; k++)
+	{
+		if(bucket[k].work != 0 && same_key(bucket+k,key))
+		{
+			*count = bucket[k].count;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void put_entry(transposition_table *table, unsigned long *key, int count, int work)
+{
+	/*
+	 * Puts the entry of key in its bucket: over the entry that already has key, in an empty entry,
+	 * or over the entry with the least work in the bucket, unless it has more work than this one.
+	 */
+	table_entry *bucket = table->entries + (key[0] & table->bucket_mask)*BUCKET_SIZE;
+	table_entry *victim = bucket;
+	int k;
+	for(k = 0; k < BUCKET_SIZE; k++)
+	{
+		if(bucket[k].work == 0 || same_key(bucket+k,key))
+		{/*an empty entry, or the key is already there*/
+			victim = bucket+k;
+			break;
+		}
+		if(bucket[k].work < victim->work)
+		{
+			victim = bucket+k;
+		}
+	}
+	if(victim->work > work)
+	{/*every entry in the bucket saves more search than this one*/
+		return;
+	}
+	if(victim->work == 0)
+	{
+		table->num_used++;
+	}
+	for(k = 0; k < KEY_WORDS; k++)
+	{
+		victim->key[k] = key[k];
+	}
+	victim->count = count;
+	victim->work = work;
+}
+
+static void grow_table(transposition_table *table)
+{
+	/*
+	 * Doubles the number of buckets of table and puts its entries in the new buckets.
+	 * Terminates the program on a memory allocation error.
+	 */
+	table_entry *old_entries = table->entries;
+	unsigned long k, old_size = (table->bucket_mask + 1)*BUCKET_SIZE;
+
+	table->entries = (table_entry*)calloc(2*old_size,sizeof(table_entry));
+	check_alloc(table->entries,"store_count");
+	table->bucket_mask = 2*table->bucket_mask + 1;
+	table->num_used = 0;
+	for(k = 0; k < old_size; k++)
+	{
+		if(old_entries[k].work != 0)
+		{
+			put_entry(table,old_entries[k].key,old_entries[k].count,old_entries[k].work);
+		}
+	}
+	free(old_entries);
+}
+
+void store_count(transposition_table *table, unsigned long *key, int count, unsigned long work)
+{
+	/*
+	 * Remembers that the subtree with the given key has count solutions and that counting them took work search nodes.
+	 * If the key's bucket is full, the entry with the least work in it is replaced, unless it has more work than this one.
+	 * The entry keeps work+1, so a subtree that took no search nodes (all its digits fail to propagate) doesn't look empty.
+	 */
+	if(table->bucket_mask + 1 < table->max_buckets && 2*table->num_used >= (table->bucket_mask + 1)*BUCKET_SIZE)
+	{/*half full, there is room to grow*/
+		grow_table(table);
+	}
+	put_entry(table,key,count,(work >= INT_MAX) ? INT_MAX : (int)work + 1);
+}
@@ -0,0 +1,78 @@
+#ifndef TRANSPOSITION_H_
+#define TRANSPOSITION_H_
+
+#include <stdlib.h>
+#include "definitions.h"
+
+/*
+ * This module is the transposition table of the solution counter: a fixed size hash table that
+ * remembers how many solutions a subtree of the search has, keyed by the hash of the remaining
+ * constraints at its root (see candidates.h). A subtree that is reached again is counted once.
+ * The table starts small and doubles as it fills, up to its memory cap, so a short count doesn't pay
+ * for a big table. When the table is full, the entry that took the least search to count is evicted first.
+ */
+
+/*
+ * The number of words in the key of a subtree. The table compares the whole key, so two different
+ * subtrees are mixed up only if all their key words collide.
+ */
+#define KEY_WORDS (2)
+
+/*
+ * The memory cap of the transposition tables in megabytes when memo_size wasn't called.
+ */
+#define DEFAULT_MEMO_MEGABYTES (64)
+
+/*
+ * The largest memory cap, in megabytes, memo_size accepts.
+ */
+#define MAX_MEMO_MEGABYTES (65536)
+
+typedef struct transposition_table_struct transposition_table;
+
+/*
+ * Sets the memory cap, in megabytes, of all the transposition tables of one count together.
+ * 0 turns memoization off.
+ */
+void set_memo_size(int megabytes);
+
+/*
+ * Returns the memory cap, in megabytes, set with set_memo_size.
+ */
+int get_memo_size();
+
+/*
+ * Allocates an empty transposition table that grows to at most max_bytes bytes.
+ * Returns NULL if max_bytes is too small for a useful table (so memoization is off).
+ * Uses malloc, free it with free_transposition_table.
+ * Terminates the program on a memory allocation error.
+ */
+transposition_table* new_transposition_table(size_t max_bytes);
+
+/*
+ * Allocates the transposition table of one of num_tables threads that count together: an empty table
+ * with an equal share of the memory cap set with set_memo_size.
+ * Returns NULL if memoization is off or the share is too small for a useful table.
+ * Uses malloc, free it with free_transposition_table.
+ * Terminates the program on a memory allocation error.
+ */
+transposition_table* new_count_table(int num_tables);
+
+/*
+ * Frees all memory of table. table may be NULL.
+ */
+void free_transposition_table(transposition_table *table);
+
+/*
+ * Looks up the subtree with the given key.
+ * Returns TRUE and stores its number of solutions in *count if it is in table, FALSE otherwise.
+ */
+BOOL lookup_count(transposition_table *table, unsigned long *key, int *count);
+
+/*
+ * Remembers that the subtree with the given key has count solutions and that counting them took work search nodes.
+ * If the key's bucket is full, the entry with the least work in it is replaced, unless it has more work than this one.
+ */
+void store_count(transposition_table *table, unsigned long *key, int count, unsigned long work);
+
+#endif /* TRANSPOSITION_H_ */